@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    AmpVoicing.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "AmpVoicing.h"
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::prepare (double newSampleRate, int newNumChannels)
+{
+    sampleRate = newSampleRate;
+    numChannels = juce::jlimit (1, (int) maxNumChannels, newNumChannels);
+    needsUpdate = true;
+
+    setSettings (settings);
+    reset();
+}
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::reset() noexcept
+{
+    for (auto& s : state)
+    {
+        std::fill (std::begin (s.z1), std::end (s.z1), (SampleType) 0);
+        std::fill (std::begin (s.z2), std::end (s.z2), (SampleType) 0);
+    }
+}
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::setSettings (const Settings& newSettings) noexcept
+{
+    if (newSettings == settings && ! needsUpdate)
+        return;
+
+    const auto& old = settings;
+    const auto all = needsUpdate;
+
+    if (all || newSettings.lowCut != old.lowCut)
+        updateSection (inputHighPass, newSettings.lowCut > minLowCut, makeHighPass (sampleRate, newSettings.lowCut));
+
+    if (all || newSettings.emphasis != old.emphasis)
+    {
+        auto on = newSettings.emphasis != 0;
+        updateSection (preEmphasis, on, makeShelf (sampleRate, emphasisFrequency, newSettings.emphasis, true));
+        updateSection (deEmphasis, on, makeShelf (sampleRate, emphasisFrequency, -newSettings.emphasis, true));
+    }
+
+    if (all || newSettings.bass != old.bass)
+        updateSection (bassShelf, newSettings.bass != 0, makeShelf (sampleRate, bassFrequency, newSettings.bass, false));
+
+    if (all || newSettings.mid != old.mid)
+        updateSection (midPeak, newSettings.mid != 0, makePeak (sampleRate, midFrequency, midQ, newSettings.mid));
+
+    if (all || newSettings.treble != old.treble)
+        updateSection (trebleShelf, newSettings.treble != 0, makeShelf (sampleRate, trebleFrequency, newSettings.treble, true));
+
+    if (all || newSettings.cabinet != old.cabinet)
+        updateSection (cabinetLowPass, newSettings.cabinet < maxCabinet, makeLowPass (sampleRate, newSettings.cabinet));
+
+    settings = newSettings;
+    needsUpdate = false;
+}
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::updateSection (int section, bool isActive, const Coefficients& newCoefficients) noexcept
+{
+    // A section coming back from bypass starts from silence, not stale state
+    if (isActive && ! active[section])
+    {
+        std::fill (std::begin (state[section].z1), std::end (state[section].z1), (SampleType) 0);
+        std::fill (std::begin (state[section].z2), std::end (state[section].z2), (SampleType) 0);
+    }
+
+    active[section] = isActive;
+    coefficients[section] = newCoefficients;
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType AmpVoicing<SampleType>::getMaximumGain() const noexcept
+{
+    // Butterworth high- and low-passes never exceed unity, the boosting
+    // shelves and the peak top out at their gain.
+    auto boost = [] (float gainDb) { return (SampleType) juce::Decibels::decibelsToGain (juce::jmax (0.0f, gainDb)); };
+
+    SampleType gain = 1;
+
+    if (active[preEmphasis])  gain *= boost (settings.emphasis);
+    if (active[bassShelf])    gain *= boost (settings.bass);
+    if (active[midPeak])      gain *= boost (settings.mid);
+    if (active[trebleShelf])  gain *= boost (settings.treble);
+
+    return gain;
+}
+
+template <typename SampleType>
+int AmpVoicing<SampleType>::getTailLengthSamples() const noexcept
+{
+    const double frequencies[numSections] = { settings.lowCut, emphasisFrequency, emphasisFrequency,
+                                              bassFrequency, midFrequency, trebleFrequency, settings.cabinet };
+    auto lowest = 0.0;
+
+    for (int section = 0; section < numSections; ++section)
+        if (active[section])
+            lowest = lowest > 0 ? juce::jmin (lowest, frequencies[section]) : frequencies[section];
+
+    // A few periods of the lowest active corner covers the decay
+    return lowest > 0 ? juce::roundToInt (4.0 * sampleRate / lowest) : 0;
+}
+
+template <typename SampleType>
+bool AmpVoicing<SampleType>::isActive() const noexcept
+{
+    for (auto sectionActive : active)
+        if (sectionActive)
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+template <typename SampleType>
+void AmpVoicing<SampleType>::processPre (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    processSections (block, inputHighPass, firstPostSection);
+}
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::processPost (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    processSections (block, firstPostSection, numSections);
+}
+
+template <typename SampleType>
+void AmpVoicing<SampleType>::processSections (const juce::dsp::AudioBlock<SampleType>& block, int firstSection, int endSection) noexcept
+{
+    int sections[numSections];
+    int numActive = 0;
+
+    for (int section = firstSection; section < endSection; ++section)
+        if (active[section])
+            sections[numActive++] = section;
+
+    if (numActive == 0)
+        return;
+
+    const auto numSamples = (int) block.getNumSamples();
+    const auto channels = juce::jmin ((int) block.getNumChannels(), numChannels);
+
+    SampleType* data[maxNumChannels];
+
+    for (int channel = 0; channel < channels; ++channel)
+        data[channel] = block.getChannelPointer ((size_t) channel);
+
+    // One section at a time over the whole block keeps its coefficients and
+    // state in registers for the inner loop.
+    for (int s = 0; s < numActive; ++s)
+    {
+        const auto section = sections[s];
+        const auto& c = coefficients[section];
+        auto& st = state[section];
+        int channel = 0;
+
+        for (; channel + 4 <= channels; channel += 4)
+            processLanes<4> (data + channel, numSamples, c, st.z1 + channel, st.z2 + channel);
+
+        for (; channel + 2 <= channels; channel += 2)
+            processLanes<2> (data + channel, numSamples, c, st.z1 + channel, st.z2 + channel);
+
+        if (channel < channels)
+            processLanes<1> (data + channel, numSamples, c, st.z1 + channel, st.z2 + channel);
+    }
+}
+
+template <typename SampleType>
+template <int numLanes>
+void AmpVoicing<SampleType>::processLanes (SampleType* const* channels, int numSamples, const Coefficients& c,
+                                           SampleType* z1, SampleType* z2) noexcept
+{
+    SampleType* data[numLanes];
+    SampleType s1[numLanes], s2[numLanes];
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        data[lane] = channels[lane];
+        s1[lane] = z1[lane];
+        s2[lane] = z2[lane];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto x = data[lane][i];
+            const auto y = c.b0 * x + s1[lane];
+            s1[lane] = c.b1 * x - c.a1 * y + s2[lane];
+            s2[lane] = c.b2 * x - c.a2 * y;
+            data[lane][i] = y;
+        }
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        z1[lane] = s1[lane];
+        z2[lane] = s2[lane];
+    }
+}
+
+//==============================================================================
+// Robert Bristow-Johnson's cookbook designs, normalised by a0.
+namespace
+{
+    template <typename Coefficients>
+    Coefficients normalise (double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        using Sample = decltype (Coefficients::b0);
+        return { (Sample) (b0 / a0), (Sample) (b1 / a0), (Sample) (b2 / a0), (Sample) (a1 / a0), (Sample) (a2 / a0) };
+    }
+
+    constexpr double butterworthQ = 0.7071067811865476;
+
+    double getOmega (double sampleRate, double frequency) noexcept
+    {
+        // Keep the corner clear of Nyquist, where the designs fold over
+        return juce::MathConstants<double>::twoPi * juce::jmin (frequency, sampleRate * 0.45) / sampleRate;
+    }
+}
+
+template <typename SampleType>
+typename AmpVoicing<SampleType>::Coefficients AmpVoicing<SampleType>::makeHighPass (double sr, double frequency) noexcept
+{
+    const auto w = getOmega (sr, frequency);
+    const auto cosW = std::cos (w);
+    const auto alpha = std::sin (w) / (2.0 * butterworthQ);
+
+    return normalise<Coefficients> ((1.0 + cosW) / 2.0, -(1.0 + cosW), (1.0 + cosW) / 2.0,
+                                    1.0 + alpha, -2.0 * cosW, 1.0 - alpha);
+}
+
+template <typename SampleType>
+typename AmpVoicing<SampleType>::Coefficients AmpVoicing<SampleType>::makeLowPass (double sr, double frequency) noexcept
+{
+    const auto w = getOmega (sr, frequency);
+    const auto cosW = std::cos (w);
+    const auto alpha = std::sin (w) / (2.0 * butterworthQ);
+
+    return normalise<Coefficients> ((1.0 - cosW) / 2.0, 1.0 - cosW, (1.0 - cosW) / 2.0,
+                                    1.0 + alpha, -2.0 * cosW, 1.0 - alpha);
+}
+
+template <typename SampleType>
+typename AmpVoicing<SampleType>::Coefficients AmpVoicing<SampleType>::makePeak (double sr, double frequency, double q, double gainDb) noexcept
+{
+    const auto w = getOmega (sr, frequency);
+    const auto cosW = std::cos (w);
+    const auto alpha = std::sin (w) / (2.0 * q);
+    const auto a = std::pow (10.0, gainDb / 40.0);
+
+    return normalise<Coefficients> (1.0 + alpha * a, -2.0 * cosW, 1.0 - alpha * a,
+                                    1.0 + alpha / a, -2.0 * cosW, 1.0 - alpha / a);
+}
+
+template <typename SampleType>
+typename AmpVoicing<SampleType>::Coefficients AmpVoicing<SampleType>::makeShelf (double sr, double frequency, double gainDb, bool high) noexcept
+{
+    // Shelf slope 1, the steepest without overshoot
+    const auto w = getOmega (sr, frequency);
+    const auto cosW = std::cos (w);
+    const auto a = std::pow (10.0, gainDb / 40.0);
+    const auto beta = std::sqrt (2.0 * a) * std::sin (w);
+
+    if (high)
+        return normalise<Coefficients> (a * ((a + 1.0) + (a - 1.0) * cosW + beta),
+                                        -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW),
+                                        a * ((a + 1.0) + (a - 1.0) * cosW - beta),
+                                        (a + 1.0) - (a - 1.0) * cosW + beta,
+                                        2.0 * ((a - 1.0) - (a + 1.0) * cosW),
+                                        (a + 1.0) - (a - 1.0) * cosW - beta);
+
+    return normalise<Coefficients> (a * ((a + 1.0) - (a - 1.0) * cosW + beta),
+                                    2.0 * a * ((a - 1.0) - (a + 1.0) * cosW),
+                                    a * ((a + 1.0) - (a - 1.0) * cosW - beta),
+                                    (a + 1.0) + (a - 1.0) * cosW + beta,
+                                    -2.0 * ((a - 1.0) + (a + 1.0) * cosW),
+                                    (a + 1.0) + (a - 1.0) * cosW - beta);
+}
+
+template class AmpVoicing<float>;
+template class AmpVoicing<double>;
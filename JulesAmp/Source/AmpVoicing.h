@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    AmpVoicing.h
+    Created: 17 Oct 2026
+
+    The linear filters around the shaper that make it sound like an amp:
+    an input high-pass and a pre-emphasis shelf ahead of the distortion, and
+    after it the matching de-emphasis, a bass/mid/treble tone stack and a
+    cabinet-style low-pass. Everything runs at the host rate, outside the
+    oversampling stage.
+
+    Filters are plain biquads whose coefficients are only recomputed when a
+    setting moves. Their state is stored per section as one aligned array
+    per delay element, indexed by channel, and a section runs up to four
+    neighbouring channels side by side, a sample at a time. A biquad waits
+    on its own last output every sample; the lanes' recursions are
+    independent, so they overlap rather than queue. Sections left at their
+    neutral setting are skipped entirely, so the default voicing costs
+    nothing and sounds exactly like the bare shaper.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <typename SampleType>
+class AmpVoicing
+{
+public:
+    static constexpr int maxNumChannels = 32;
+
+    struct Settings
+    {
+        float lowCut = minLowCut;       // Hz, input high-pass
+        float emphasis = 0;             // dB of treble boost into the shaper, taken back out after it
+        float bass = 0, mid = 0, treble = 0;   // dB
+        float cabinet = maxCabinet;     // Hz, cabinet low-pass
+
+        bool operator== (const Settings& other) const noexcept
+        {
+            return lowCut == other.lowCut && emphasis == other.emphasis && bass == other.bass
+                && mid == other.mid && treble == other.treble && cabinet == other.cabinet;
+        }
+
+        bool operator!= (const Settings& other) const noexcept   { return ! operator== (other); }
+    };
+
+    /** At these limits the high-pass and the cabinet filter are switched off. */
+    static constexpr float minLowCut = 20.0f;
+    static constexpr float maxCabinet = 20000.0f;
+
+    AmpVoicing() = default;
+
+    void prepare (double sampleRate, int numChannels);
+    void reset() noexcept;
+
+    /** Recomputes the coefficients of whichever sections changed. */
+    void setSettings (const Settings&) noexcept;
+
+    /** High-pass and pre-emphasis, run on the input before the shaper. */
+    void processPre (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+
+    /** De-emphasis, tone stack and cabinet, run on the shaper's output. */
+    void processPost (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+
+    /** Upper bound on the magnitude response of both chains together. */
+    SampleType getMaximumGain() const noexcept;
+
+    /** How long the active filters keep ringing, in samples. */
+    int getTailLengthSamples() const noexcept;
+
+    /** False when every section is off, so both chains pass the signal through. */
+    bool isActive() const noexcept;
+
+private:
+    enum Section
+    {
+        inputHighPass,
+        preEmphasis,
+        deEmphasis,
+        bassShelf,
+        midPeak,
+        trebleShelf,
+        cabinetLowPass,
+        numSections,
+
+        firstPostSection = deEmphasis
+    };
+
+    struct Coefficients
+    {
+        SampleType b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    };
+
+    // Transposed direct form II: two delay elements per channel, each kept
+    // contiguous across channels on its own cache lines.
+    struct alignas (64) SectionState
+    {
+        alignas (64) SampleType z1[maxNumChannels];
+        alignas (64) SampleType z2[maxNumChannels];
+    };
+
+    void updateSection (int section, bool active, const Coefficients&) noexcept;
+    void processSections (const juce::dsp::AudioBlock<SampleType>&, int firstSection, int endSection) noexcept;
+
+    /** One section over numLanes neighbouring channels, whose state starts at z1 and z2. */
+    template <int numLanes>
+    static void processLanes (SampleType* const* channels, int numSamples, const Coefficients&,
+                              SampleType* z1, SampleType* z2) noexcept;
+
+    static Coefficients makeHighPass (double sampleRate, double frequency) noexcept;
+    static Coefficients makeLowPass (double sampleRate, double frequency) noexcept;
+    static Coefficients makePeak (double sampleRate, double frequency, double q, double gainDb) noexcept;
+    static Coefficients makeShelf (double sampleRate, double frequency, double gainDb, bool high) noexcept;
+
+    // Fixed voicing of the tone stack and the emphasis shelf
+    static constexpr double bassFrequency = 120.0;
+    static constexpr double midFrequency = 800.0, midQ = 0.7;
+    static constexpr double trebleFrequency = 3200.0;
+    static constexpr double emphasisFrequency = 720.0;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    Settings settings;
+    bool needsUpdate = true;
+
+    Coefficients coefficients[numSections];
+    bool active[numSections] = {};
+    SectionState state[numSections];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AmpVoicing)
+};
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    CabinetConvolver.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "CabinetConvolver.h"
+
+void CabinetConvolver::prepare (double sampleRate, int maximumBlockSize, int numChannels)
+{
+    spec = { sampleRate, (juce::uint32) juce::jmax (1, maximumBlockSize), 2 };
+    numChannels = juce::jmax (1, numChannels);
+
+    for (int pair = engines.size(); pair < (numChannels + 1) / 2; ++pair)
+    {
+        auto* engine = engines.add (new juce::dsp::Convolution (juce::dsp::Convolution::NonUniform { headSize }, messageQueue));
+
+        if (isLoaded())
+            loadInto (*engine);
+    }
+
+    for (auto* engine : engines)
+        engine->prepare (spec);
+
+    conversion.setSize (numChannels, (int) spec.maximumBlockSize);
+    silentSamples = 0;
+}
+
+void CabinetConvolver::reset() noexcept
+{
+    for (auto* engine : engines)
+        engine->reset();
+
+    silentSamples = 0;
+}
+
+bool CabinetConvolver::load (const juce::File& newFile)
+{
+    auto newImpulseResponse = resources->getImpulseResponse (newFile, maxImpulseSeconds);
+
+    if (newImpulseResponse == nullptr)
+        return false;
+
+    impulseResponse = newImpulseResponse;
+
+    for (auto* engine : engines)
+        loadInto (*engine);
+
+    loaded.store (true, std::memory_order_relaxed);
+    return true;
+}
+
+void CabinetConvolver::unload()
+{
+    loaded.store (false, std::memory_order_relaxed);
+    impulseResponse = nullptr;
+}
+
+void CabinetConvolver::loadInto (juce::dsp::Convolution& engine) const
+{
+    // The engine takes ownership of what it's given, so it gets its own copy of
+    // the shared samples; resampling and partitioning happen in the background
+    juce::AudioBuffer<float> copy (impulseResponse->buffer);
+    const auto stereo = copy.getNumChannels() > 1 ? juce::dsp::Convolution::Stereo::yes : juce::dsp::Convolution::Stereo::no;
+
+    engine.loadImpulseResponse (std::move (copy), impulseResponse->sampleRate, stereo,
+                                juce::dsp::Convolution::Trim::yes, juce::dsp::Convolution::Normalise::yes);
+}
+
+int CabinetConvolver::getTailLengthSamples() const noexcept
+{
+    return isLoaded() && ! engines.isEmpty() ? engines.getUnchecked (0)->getCurrentIRSize() : 0;
+}
+
+//==============================================================================
+bool CabinetConvolver::isSilent (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const auto range = block.findMinAndMax();
+
+    if (range.getStart() != 0 || range.getEnd() != 0)
+    {
+        silentSamples = 0;
+        return false;
+    }
+
+    if (silentSamples >= (juce::int64) (getTailLengthSamples() + headSize))
+        return true;
+
+    silentSamples += (juce::int64) block.getNumSamples();
+    return false;
+}
+
+bool CabinetConvolver::process (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (! isLoaded() || engines.isEmpty())
+        return true;
+
+    const auto numSamples = (int) block.getNumSamples();
+    const auto chunkSize = (int) spec.maximumBlockSize;
+    bool skipped = true;
+
+    // The engines were prepared for this many samples at most, and hosts may
+    // send more
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto length = juce::jmin (chunkSize, numSamples - start);
+
+        if (! processChunk (block.getSubBlock ((size_t) start, (size_t) length)))
+            skipped = false;
+    }
+
+    return skipped;
+}
+
+bool CabinetConvolver::processChunk (const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    if (isSilent (block))
+        return true;
+
+    const auto numChannels = (int) block.getNumChannels();
+
+    for (int pair = 0; pair < engines.size() && pair * 2 < numChannels; ++pair)
+    {
+        auto channels = block.getSubsetChannelBlock ((size_t) pair * 2, (size_t) juce::jmin (2, numChannels - pair * 2));
+        engines.getUnchecked (pair)->process (juce::dsp::ProcessContextReplacing<float> (channels));
+    }
+
+    return false;
+}
+
+bool CabinetConvolver::process (const juce::dsp::AudioBlock<double>& block) noexcept
+{
+    if (! isLoaded() || engines.isEmpty())
+        return true;
+
+    const auto numSamples = (int) block.getNumSamples();
+    const auto numChannels = juce::jmin ((int) block.getNumChannels(), conversion.getNumChannels());
+    const auto chunkSize = conversion.getNumSamples();
+    bool skipped = true;
+
+    // Hosts may exceed the prepared block size, so convert in chunks that fit
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto length = juce::jmin (chunkSize, numSamples - start);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* source = block.getChannelPointer ((size_t) channel) + start;
+            auto* dest = conversion.getWritePointer (channel);
+
+            for (int i = 0; i < length; ++i)
+                dest[i] = (float) source[i];
+        }
+
+        auto converted = juce::dsp::AudioBlock<float> (conversion).getSubsetChannelBlock (0, (size_t) numChannels)
+                                                                  .getSubBlock (0, (size_t) length);
+
+        if (processChunk (converted))
+            continue;
+
+        skipped = false;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* source = conversion.getReadPointer (channel);
+            auto* dest = block.getChannelPointer ((size_t) channel) + start;
+
+            for (int i = 0; i < length; ++i)
+                dest[i] = (double) source[i];
+        }
+    }
+
+    return skipped;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    CabinetConvolver.h
+    Created: 17 Oct 2026
+
+    Optional speaker cabinet stage convolving the output with a WAV/AIFF
+    impulse response. juce::dsp::Convolution does the heavy lifting: the IR
+    is read, resampled, trimmed and partitioned on the message queue's
+    background thread and swapped into the audio thread without locking,
+    and the non-uniform partitioning keeps a short head block so the stage
+    adds no latency.
+
+    Only the chosen file is read, capped at maxImpulseSeconds, so an IR
+    library never has to be held in memory. It's decoded once per process
+    through SharedResources, so a session full of instances on the same cab
+    reads the file once. The convolution engines are float only; the double
+    path converts through a scratch buffer.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedResources.h"
+
+class CabinetConvolver
+{
+public:
+    /** Longer files are trimmed to this. */
+    static constexpr double maxImpulseSeconds = 2.0;
+
+    /** Size of the zero-latency head partition, the later ones grow from it. */
+    static constexpr int headSize = 128;
+
+    CabinetConvolver() = default;
+
+    /** Message thread. Re-issues the current IR to any engine created for
+        extra channels, convolution runs on channel pairs.
+    */
+    void prepare (double sampleRate, int maximumBlockSize, int numChannels);
+    void reset() noexcept;
+
+    /** Message thread. Decodes the file unless another instance already
+        has, then prepares it in the background; the old IR keeps playing
+        until the new one is ready. Returns false if the file can't be read
+        as audio.
+    */
+    bool load (const juce::File&);
+
+    /** Message thread. Switches the stage off. */
+    void unload();
+
+    juce::File getFile() const                  { return impulseResponse != nullptr ? impulseResponse->file : juce::File(); }
+    bool isLoaded() const noexcept              { return loaded.load (std::memory_order_relaxed); }
+
+    /** Audio thread: length of the IR currently playing, in samples. */
+    int getTailLengthSamples() const noexcept;
+
+    /** Audio thread, in place. Returns true when there was nothing to do:
+        no IR is loaded, or the input has been silent for longer than the IR.
+        Blocks longer than the prepared size are run in chunks of that size.
+    */
+    bool process (const juce::dsp::AudioBlock<float>&) noexcept;
+    bool process (const juce::dsp::AudioBlock<double>&) noexcept;
+
+private:
+    bool processChunk (const juce::dsp::AudioBlock<float>&) noexcept;
+    bool isSilent (const juce::dsp::AudioBlock<float>&) noexcept;
+    void loadInto (juce::dsp::Convolution&) const;
+
+    juce::dsp::ConvolutionMessageQueue messageQueue;
+    juce::OwnedArray<juce::dsp::Convolution> engines;   // one per channel pair
+    juce::AudioBuffer<float> conversion;
+
+    juce::SharedResourcePointer<SharedResources> resources;
+    SharedResources::ImpulseResponse::Ptr impulseResponse;
+    std::atomic<bool> loaded { false };
+
+    // Zero input for longer than the IR means the engines hold nothing but
+    // zeros, so they can be skipped until signal returns.
+    juce::int64 silentSamples = 0;
+
+    juce::dsp::ProcessSpec spec { 44100.0, 0, 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabinetConvolver)
+};
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    CallbackProfiler.h
+    Created: 17 Oct 2026
+
+    Times every processBlock call against its real-time budget (the callback's
+    sample count at the current sample rate). The audio thread is the only
+    writer and only does relaxed atomic stores, so the probe never locks or
+    allocates; the editor and headless tools read a snapshot from any thread.
+
+    Build with JULESAMP_ENABLE_PROFILER=0 to remove it from the processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef JULESAMP_ENABLE_PROFILER
+ #define JULESAMP_ENABLE_PROFILER 1
+#endif
+
+class CallbackProfiler
+{
+public:
+    /** Load histogram in 10% steps, the last bucket collects every overrun. */
+    static constexpr int numBuckets = 11;
+
+    /** Number of recent callbacks averaged into Stats::averageLoad. */
+    static constexpr int historySize = 256;
+
+    struct Stats
+    {
+        juce::uint32 numCallbacks = 0;
+        juce::uint32 numOverruns = 0;
+        float lastLoad = 0;         // fraction of the budget, 1.0 = deadline
+        float averageLoad = 0;      // over the last historySize callbacks
+        float peakLoad = 0;
+        juce::uint32 histogram[numBuckets] = {};
+    };
+
+    CallbackProfiler() noexcept
+    {
+        clear();
+    }
+
+    /** Call from prepareToPlay, before the audio thread starts. */
+    void prepare (double sampleRate) noexcept
+    {
+        ticksPerSample = (double) juce::Time::getHighResolutionTicksPerSecond() / sampleRate;
+        clear();
+    }
+
+    /** Any thread: asks the audio thread to zero the stats at its next callback. */
+    void requestReset() noexcept    { resetRequested.store (true, std::memory_order_relaxed); }
+
+    /** Any thread. Fields are read one by one, so a snapshot taken during a
+        callback may mix two consecutive callbacks - fine for a display.
+    */
+    Stats getStats() const noexcept
+    {
+        Stats stats;
+        stats.numCallbacks = numCallbacks.load (std::memory_order_relaxed);
+        stats.numOverruns = numOverruns.load (std::memory_order_relaxed);
+        stats.lastLoad = lastLoad.load (std::memory_order_relaxed);
+        stats.peakLoad = peakLoad.load (std::memory_order_relaxed);
+
+        for (int i = 0; i < numBuckets; ++i)
+            stats.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+
+        auto numRecent = (int) juce::jmin (stats.numCallbacks, (juce::uint32) historySize);
+        float sum = 0;
+
+        for (int i = 0; i < numRecent; ++i)
+            sum += history[i].load (std::memory_order_relaxed);
+
+        stats.averageLoad = numRecent > 0 ? sum / (float) numRecent : 0.0f;
+        return stats;
+    }
+
+    /** Audio thread: times the enclosing scope as one callback. */
+    struct ScopedCallback
+    {
+        ScopedCallback (CallbackProfiler& p, int samples) noexcept
+            : profiler (p), numSamples (samples), startTicks (juce::Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedCallback() noexcept
+        {
+            profiler.record (juce::Time::getHighResolutionTicks() - startTicks, numSamples);
+        }
+
+        CallbackProfiler& profiler;
+        const int numSamples;
+        const juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCallback)
+    };
+
+private:
+    void record (juce::int64 elapsedTicks, int numSamples) noexcept
+    {
+        if (numSamples <= 0 || ticksPerSample <= 0)
+            return;
+
+        if (resetRequested.exchange (false, std::memory_order_relaxed))
+            clear();
+
+        auto load = (float) ((double) elapsedTicks / (ticksPerSample * numSamples));
+        auto callbacks = numCallbacks.load (std::memory_order_relaxed);
+
+        history[callbacks % historySize].store (load, std::memory_order_relaxed);
+        lastLoad.store (load, std::memory_order_relaxed);
+
+        if (load > peakLoad.load (std::memory_order_relaxed))
+            peakLoad.store (load, std::memory_order_relaxed);
+
+        if (load >= 1.0f)
+            numOverruns.store (numOverruns.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        auto& bucket = histogram[juce::jlimit (0, numBuckets - 1, (int) (load * 10.0f))];
+        bucket.store (bucket.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        numCallbacks.store (callbacks + 1, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept
+    {
+        numCallbacks.store (0, std::memory_order_relaxed);
+        numOverruns.store (0, std::memory_order_relaxed);
+        lastLoad.store (0, std::memory_order_relaxed);
+        peakLoad.store (0, std::memory_order_relaxed);
+
+        for (auto& bucket : histogram)
+            bucket.store (0, std::memory_order_relaxed);
+
+        for (auto& load : history)
+            load.store (0, std::memory_order_relaxed);
+    }
+
+    double ticksPerSample = 0;
+
+    // Single writer (the audio thread), so plain load/store pairs are enough
+    std::atomic<juce::uint32> numCallbacks, numOverruns;
+    std::atomic<float> lastLoad, peakLoad;
+    std::atomic<juce::uint32> histogram[numBuckets];
+    std::atomic<float> history[historySize];
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CallbackProfiler)
+};
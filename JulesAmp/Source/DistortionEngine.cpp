@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+
+    DistortionEngine.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "DistortionEngine.h"
+
+template <typename SampleType>
+DistortionEngine<SampleType>::DistortionEngine (ShaperTable& table)
+    : shaperTable (table)
+{
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::prepare (double newSampleRate, int maximumBlockSize, int numChannels)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax (1, maximumBlockSize);
+    numChannels = juce::jlimit (1, (int) maxNumChannels, numChannels);
+
+    // Ramps run at the shaper's rate, so leave room for the largest oversampling factor
+    ramps.setSize (numRamps, maxBlockSize << maxOversamplingOrder);
+
+    // One oversampler per filter type and factor, so switching never allocates.
+    // Index = filter * maxOversamplingOrder + (order - 1)
+    oversamplers.clear();
+
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+    for (auto filterType : { Oversampling::filterHalfBandPolyphaseIIR,
+                             Oversampling::filterHalfBandFIREquiripple })
+    {
+        for (size_t order = 1; order <= (size_t) maxOversamplingOrder; ++order)
+        {
+            auto* os = oversamplers.add (new Oversampling ((size_t) numChannels, order, filterType, true, true));
+            os->initProcessing ((size_t) maxBlockSize);
+        }
+    }
+
+    multiband.prepare (sampleRate, maxOversamplingOrder, maxBlockSize, numChannels);
+    follower.prepare (sampleRate, maxBlockSize);
+    waveshaper.prepare (maxBlockSize << maxOversamplingOrder, numChannels);
+    voicing.prepare (sampleRate, numChannels);
+
+    oversampler = nullptr;
+    oversamplingIndex = -1;
+    silentSamples = 0;
+    skipping = false;
+    resetSmoothers();
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::setOversampling (int quality, int filter) noexcept
+{
+    auto index = quality > 0 ? filter * maxOversamplingOrder + (quality - 1) : -1;
+
+    if (index == oversamplingIndex || index >= oversamplers.size())
+        return false;
+
+    oversamplingIndex = index;
+    oversampler = oversamplers[index];
+
+    if (oversampler != nullptr)
+        oversampler->reset();
+
+    multiband.setOversamplingOrder (juce::jmax (0, quality));
+    resetSmoothers();
+    return true;
+}
+
+template <typename SampleType>
+int DistortionEngine<SampleType>::getLatencySamples() const noexcept
+{
+    return oversampler != nullptr ? juce::roundToInt (oversampler->getLatencyInSamples()) : 0;
+}
+
+template <typename SampleType>
+int DistortionEngine<SampleType>::getTailLengthSamples() const noexcept
+{
+    // The down-sampling filter's impulse response spans about twice its
+    // latency; the margin covers the IIR designs' decay past that. The
+    // crossovers and the voicing filters add their own ring-out.
+    auto oversamplingTail = oversampler != nullptr ? 2 * getLatencySamples() + oversamplingTailMargin : 0;
+    return oversamplingTail + multiband.getTailLengthSamples() + voicing.getTailLengthSamples();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::setCurve (int curve) noexcept
+{
+    if (curve == waveshaper.getCurve())
+        return;
+
+    auto shaperSampleRate = sampleRate * (oversampler != nullptr ? (double) oversampler->getOversamplingFactor() : 1.0);
+    waveshaper.setCurve (curve, juce::roundToInt (smoothingTimeSeconds * shaperSampleRate));
+}
+
+//==============================================================================
+template <typename SampleType>
+void DistortionEngine<SampleType>::setTarget (int parameter, float value) noexcept
+{
+    if (! juce::isPositiveAndBelow (parameter, (int) numAutomatedParameters))
+        return;
+
+    targets[parameter] = value;
+
+    switch (parameter)
+    {
+        case driveParameter:  driveSmoother.setTargetValue ((SampleType) value); break;
+        case rangeParameter:  rangeSmoother.setTargetValue ((SampleType) juce::jmax (minimumSmoothedRange, value)); break;
+        case blendParameter:  blendSmoother.setTargetValue ((SampleType) value); break;
+        case volumeParameter: volumeSmoother.setTargetValue ((SampleType) value); break;
+        default: break;
+    }
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::setCurrentAndTarget (int parameter, float value) noexcept
+{
+    if (! juce::isPositiveAndBelow (parameter, (int) numAutomatedParameters))
+        return;
+
+    targets[parameter] = value;
+
+    switch (parameter)
+    {
+        case driveParameter:  driveSmoother.setCurrentAndTargetValue ((SampleType) value); break;
+        case rangeParameter:  rangeSmoother.setCurrentAndTargetValue ((SampleType) juce::jmax (minimumSmoothedRange, value)); break;
+        case blendParameter:  blendSmoother.setCurrentAndTargetValue ((SampleType) value); break;
+        case volumeParameter: volumeSmoother.setCurrentAndTargetValue ((SampleType) value); break;
+        default: break;
+    }
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::resetSmoothers() noexcept
+{
+    auto shaperSampleRate = sampleRate * (oversampler != nullptr ? (double) oversampler->getOversamplingFactor() : 1.0);
+
+    driveSmoother.reset (shaperSampleRate, smoothingTimeSeconds);
+    rangeSmoother.reset (shaperSampleRate, smoothingTimeSeconds);
+    blendSmoother.reset (shaperSampleRate, smoothingTimeSeconds);
+    volumeSmoother.reset (shaperSampleRate, smoothingTimeSeconds);
+
+    driveSmoother.setCurrentAndTargetValue ((SampleType) targets[driveParameter]);
+    rangeSmoother.setCurrentAndTargetValue ((SampleType) juce::jmax (minimumSmoothedRange, targets[rangeParameter]));
+    blendSmoother.setCurrentAndTargetValue ((SampleType) targets[blendParameter]);
+    volumeSmoother.setCurrentAndTargetValue ((SampleType) targets[volumeParameter]);
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::snapToTargets() noexcept
+{
+    resetSmoothers();
+    multiband.resetSmoothers();
+    waveshaper.advanceFade (std::numeric_limits<int>::max());
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isSmoothing() const noexcept
+{
+    return driveSmoother.isSmoothing() || rangeSmoother.isSmoothing()
+        || blendSmoother.isSmoothing() || volumeSmoother.isSmoothing();
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::skipSmoothers (int numSamples) noexcept
+{
+    driveSmoother.skip (numSamples);
+    rangeSmoother.skip (numSamples);
+    blendSmoother.skip (numSamples);
+    volumeSmoother.skip (numSamples);
+    multiband.skipSmoothers (numSamples);
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isIdentity() const noexcept
+{
+    // Fully dry at Volume 2 the shaper passes its input through, and the
+    // follower only ever scales Blend, which stays at 0. With flat voicing
+    // and a single band nothing else in the chain touches the signal.
+    return ! isSmoothing() && multiband.getNumBands() == 1 && ! voicing.isActive()
+        && blendSmoother.getCurrentValue() == 0 && volumeSmoother.getCurrentValue() == 2;
+}
+
+template <typename SampleType>
+bool DistortionEngine<SampleType>::isSilent (const juce::dsp::AudioBlock<const SampleType>& block) const noexcept
+{
+    // No curve is steeper than 1.5 (the cubic at the origin), so 1.5 * x * gain
+    // bounds the shaper's output for any curve and blend. Both smoothers ramp
+    // monotonically, so the larger of current and target covers every sample
+    // of the block.
+    auto bound = [] (const auto& smoother) { return juce::jmax (smoother.getCurrentValue(), smoother.getTargetValue()); };
+
+    auto gain = multiband.getNumBands() > 1 ? multiband.getMaximumGain()
+                                            : bound (driveSmoother) * bound (rangeSmoother);
+
+    if (follower.isActive())
+        gain *= follower.getMaximumMultiplier();
+
+    // The voicing filters are linear, so their peak gain scales the bound too.
+    auto maxGain = (gain * (SampleType) 1.5 + 1) / 2 * bound (volumeSmoother) * voicing.getMaximumGain();
+
+    auto range = block.findMinAndMax();
+    auto peak = juce::jmax (-range.getStart(), range.getEnd());
+
+    return peak * maxGain <= (SampleType) silenceThreshold;
+}
+
+//==============================================================================
+template <typename SampleType>
+bool DistortionEngine<SampleType>::process (juce::dsp::AudioBlock<SampleType> block,
+                                            const juce::dsp::AudioBlock<const SampleType>& key,
+                                            const juce::dsp::AudioBlock<const SampleType>& bus) noexcept
+{
+    jassert ((int) block.getNumSamples() <= maxBlockSize);
+    jassert (key.getNumSamples() == block.getNumSamples() && bus.getNumSamples() == block.getNumSamples());
+
+    const auto numSamples = (int) block.getNumSamples();
+    const auto factor = oversampler != nullptr ? (int) oversampler->getOversamplingFactor() : 1;
+
+    // The key and the bus may be the input itself, so they're measured before
+    // anything below changes the block. The key keeps tracking through silent blocks.
+    driveModulation = blendModulation = nullptr;
+
+    if (follower.isActive())
+    {
+        follower.process (key);
+        driveModulation = follower.getDriveMultipliers();
+        blendModulation = follower.getBlendMultipliers();
+    }
+
+    modulationShift = oversampler != nullptr ? oversamplingIndex % maxOversamplingOrder + 1 : 0;
+
+    // Silent input is only skipped once the oversampling filters have rung
+    // out, so the output fades exactly as it would have when processed.
+    if (isSilent (bus))
+    {
+        if (silentSamples >= getTailLengthSamples())
+        {
+            // Whatever state is left in the filters is below the threshold;
+            // clearing it means the next signal starts from a clean slate.
+            if (! skipping)
+            {
+                if (oversampler != nullptr)
+                    oversampler->reset();
+
+                voicing.reset();
+            }
+
+            skipping = true;
+            block.clear();
+            skipSmoothers (numSamples * factor);
+            waveshaper.advanceFade (numSamples * factor);
+            return true;
+        }
+
+        silentSamples += numSamples;
+    }
+    else
+    {
+        silentSamples = 0;
+    }
+
+    skipping = false;
+
+    // The identity skips the voicing and the shaper. The oversampling filters
+    // still run, so the output keeps the latency we report, and their state
+    // is current when a parameter moves and shaping picks up again.
+    if (isIdentity())
+    {
+        if (oversampler != nullptr)
+        {
+            oversampler->processSamplesUp (block);
+            oversampler->processSamplesDown (block);
+        }
+
+        skipSmoothers (numSamples * factor);
+        waveshaper.advanceFade (numSamples * factor);
+        return false;
+    }
+
+    voicing.processPre (block);
+
+    if (oversampler == nullptr)
+    {
+        shape (block);
+    }
+    else
+    {
+        auto upBlock = oversampler->processSamplesUp (block);
+        shape (upBlock);
+        oversampler->processSamplesDown (block);
+    }
+
+    voicing.processPost (block);
+    return false;
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::shape (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    shapeBlock (block);
+
+    // Every path above saw the same fade position, so it moves on once per block
+    waveshaper.advanceFade ((int) block.getNumSamples());
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::shapeBlock (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    auto numSamples = (int) block.getNumSamples();
+    auto numChannels = (int) juce::jmin (block.getNumChannels(), (size_t) maxNumChannels);
+
+    // The kernels walk every channel per vector of samples, so the whole bus
+    // goes through one call.
+    SampleType* channels[maxNumChannels];
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[channel] = block.getChannelPointer ((size_t) channel);
+
+    if (multiband.getNumBands() > 1)
+    {
+        multiband.process (block, waveshaper, driveModulation, blendModulation, modulationShift);
+
+        driveSmoother.skip (numSamples);
+        rangeSmoother.skip (numSamples);
+        blendSmoother.skip (numSamples);
+        applyVolume (channels, numChannels, numSamples);
+        return;
+    }
+
+    // Settled parameters skip ramp generation entirely and cost the same as
+    // an unsmoothed block. The follower moves its curves every hop, so it always ramps.
+    if (! isSmoothing() && driveModulation == nullptr && blendModulation == nullptr)
+    {
+        auto gain = driveSmoother.getCurrentValue() * rangeSmoother.getCurrentValue();
+        auto blend = blendSmoother.getCurrentValue();
+        auto volume = volumeSmoother.getCurrentValue();
+
+        // With Blend fully dry the curve is a plain gain of volume / 2, and
+        // at Volume 2 that's the identity, so there's nothing to evaluate.
+        if (blend == 0)
+        {
+            if (volume != 2)
+                block.multiplyBy (volume / 2);
+
+            return;
+        }
+
+        // The table, when enabled and already built for this curve, replaces
+        // the direct path where it's the faster one: scalar kernels on a
+        // transcendental curve. Until it's ready, or while a curve change is
+        // still crossfading, we keep shaping directly.
+        const ShaperTable::Table* table = nullptr;
+        const auto implementation = waveshaper.getImplementation();
+        const auto referenceMaths = implementation == Waveshaper<SampleType>::Implementation::reference;
+
+        if (tableResolution != ShaperTable::off && ! waveshaper.isFading()
+             && (referenceMaths || implementation == Waveshaper<SampleType>::Implementation::scalar)
+             && ShaperTable::beatsDirectPath (waveshaper.getCurve(), referenceMaths))
+        {
+            ShaperTable::Settings tableSettings { tableResolution, waveshaper.getCurve() };
+            shaperTable.requestSettings (tableSettings);
+            table = shaperTable.getTableFor (tableSettings);
+        }
+
+        if (table == nullptr)
+        {
+            waveshaper.process (channels, numChannels, numSamples, gain, blend, volume);
+            return;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            ShaperTable::process (*table, channels[channel], numSamples, gain, blend, volume);
+
+        return;
+    }
+
+    auto* gain = ramps.getWritePointer (gainRamp);
+    auto* blend = ramps.getWritePointer (blendRamp);
+    auto* volume = ramps.getWritePointer (volumeRamp);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        gain[i] = driveSmoother.getNextValue() * rangeSmoother.getNextValue();
+        blend[i] = blendSmoother.getNextValue();
+        volume[i] = volumeSmoother.getNextValue();
+    }
+
+    if (driveModulation != nullptr)
+        for (int i = 0; i < numSamples; ++i)
+            gain[i] *= driveModulation[i >> modulationShift];
+
+    if (blendModulation != nullptr)
+        for (int i = 0; i < numSamples; ++i)
+            blend[i] *= blendModulation[i >> modulationShift];
+
+    waveshaper.processRamped (channels, numChannels, numSamples, gain, blend, volume);
+}
+
+template <typename SampleType>
+void DistortionEngine<SampleType>::applyVolume (SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (! volumeSmoother.isSmoothing())
+    {
+        auto volume = volumeSmoother.getCurrentValue();
+
+        if (volume != 1)
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::multiply (channels[channel], volume, numSamples);
+
+        return;
+    }
+
+    auto* volume = ramps.getWritePointer (volumeRamp);
+
+    for (int i = 0; i < numSamples; ++i)
+        volume[i] = volumeSmoother.getNextValue();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::multiply (channels[channel], volume, numSamples);
+}
+
+template class DistortionEngine<float>;
+template class DistortionEngine<double>;
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    DistortionEngine.h
+    Created: 17 Oct 2026
+
+    The per-sample-type half of the DSP: parameter smoothers, oversampling,
+    the shaper and the amp voicing filters around it. The processor owns one
+    engine per precision, reads parameters and schedules events, and hands
+    the engine sub-blocks no longer than the prepared block size.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Waveshaper.h"
+#include "ShaperTable.h"
+#include "MultibandShaper.h"
+#include "AmpVoicing.h"
+#include "EnvelopeFollower.h"
+
+/** Parameters smoothed per sample, which can also be scheduled sample-accurately. */
+enum AutomatedParameter
+{
+    driveParameter,
+    rangeParameter,
+    blendParameter,
+    volumeParameter,
+    numAutomatedParameters
+};
+
+template <typename SampleType>
+class DistortionEngine
+{
+public:
+    explicit DistortionEngine (ShaperTable&);
+
+    /** The widest bus one instance processes, e.g. 9.1.6 or third-order ambisonics. */
+    static constexpr int maxNumChannels = 32;
+
+    void prepare (double sampleRate, int maximumBlockSize, int numChannels);
+
+    /** Selects the oversampling stage. Returns true when it changed, in which
+        case the latency may have changed too.
+    */
+    bool setOversampling (int quality, int filter) noexcept;
+    int getLatencySamples() const noexcept;
+
+    /** How long, in host samples, the output can keep ringing after the input
+        goes silent. Zero unless an oversampling stage or a filter is active.
+    */
+    int getTailLengthSamples() const noexcept;
+
+    void setTableResolution (int resolution) noexcept   { tableResolution = resolution; }
+
+    /** Selects the transfer curve (a Waveshaper::Curve), crossfading from the
+        previous one over the smoothing time so switching doesn't click.
+    */
+    void setCurve (int curve) noexcept;
+
+    /** Multiband mode: 1 band is the plain full-band shaper. Band parameters
+        are MultibandShaper::BandParameter values and are smoothed, but can't
+        be scheduled sample-accurately.
+    */
+    void setNumBands (int numBands) noexcept                            { multiband.setNumBands (numBands); }
+    void setCrossover (int index, float frequency) noexcept             { multiband.setCrossover (index, frequency); }
+    void setBandTarget (int band, int parameter, float value) noexcept  { multiband.setTarget (band, parameter, value); }
+
+    /** Input high-pass, emphasis, tone stack and cabinet around the shaper.
+        Filters are only redesigned when a setting actually changes.
+    */
+    void setVoicing (const typename AmpVoicing<SampleType>::Settings& settings) noexcept  { voicing.setSettings (settings); }
+
+    /** Dynamic drive and ducking: an envelope follower on the key signal
+        scales drive * range and Blend. See EnvelopeFollower::setParameters,
+        depth and duck both 0 turn it off.
+    */
+    void setDynamics (float depth, float duck, float attackMs, float releaseMs, bool rms) noexcept
+    {
+        follower.setParameters (depth, duck, attackMs, releaseMs, rms);
+    }
+
+    /** Starts ramping towards a new value from the next processed sample. */
+    void setTarget (int parameter, float value) noexcept;
+
+    /** Jumps to a new value from the next processed sample, without a ramp.
+        Scheduled events use this, so a stepped automation lane steps.
+    */
+    void setCurrentAndTarget (int parameter, float value) noexcept;
+
+    /** Snaps every smoother to its target. */
+    void resetSmoothers() noexcept;
+
+    /** Starts from the current settings without gliding in: snaps every
+        smoother, the bands' included, and finishes any curve crossfade. For
+        an engine that was just prepared and configured.
+    */
+    void snapToTargets() noexcept;
+
+    int getMaximumBlockSize() const noexcept            { return maxBlockSize; }
+
+    /** Processes in place, block must not be longer than getMaximumBlockSize().
+        Returns true when the block was silent and the DSP was skipped.
+    */
+    bool process (juce::dsp::AudioBlock<SampleType> block) noexcept     { return process (block, block); }
+
+    /** As above, with the dynamics detector listening to key instead of the
+        input. key must be as long as block.
+    */
+    bool process (juce::dsp::AudioBlock<SampleType> block, const juce::dsp::AudioBlock<const SampleType>& key) noexcept
+    {
+        return process (block, key, block);
+    }
+
+    /** As above, for an engine rendering one group of a wider bus. bus is the
+        whole bus' unprocessed input for the same samples; the silence check
+        covers all of it, so every group skips exactly the blocks a single
+        engine on the whole bus would.
+    */
+    bool process (juce::dsp::AudioBlock<SampleType>, const juce::dsp::AudioBlock<const SampleType>& key,
+                  const juce::dsp::AudioBlock<const SampleType>& bus) noexcept;
+
+    /** Output-referred level (about -120 dBFS) below which a block counts as silent. */
+    static constexpr double silenceThreshold = 1.0e-6;
+
+private:
+    bool isSmoothing() const noexcept;
+    bool isIdentity() const noexcept;
+    bool isSilent (const juce::dsp::AudioBlock<const SampleType>&) const noexcept;
+    void skipSmoothers (int numSamples) noexcept;
+    void shape (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+    void shapeBlock (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+    void applyVolume (SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    Waveshaper<SampleType> waveshaper;
+    ShaperTable& shaperTable;
+    int tableResolution = ShaperTable::off;
+    MultibandShaper<SampleType> multiband;
+    AmpVoicing<SampleType> voicing;
+    EnvelopeFollower<SampleType> follower;
+
+    // The follower's host-rate drive and blend multipliers for the block being
+    // shaped, null when off. Shaper sample i reads entry i >> modulationShift.
+    const SampleType* driveModulation = nullptr;
+    const SampleType* blendModulation = nullptr;
+    int modulationShift = 0;
+
+    static constexpr int maxOversamplingOrder = 3; // 8x
+    juce::OwnedArray<juce::dsp::Oversampling<SampleType>> oversamplers;
+    juce::dsp::Oversampling<SampleType>* oversampler = nullptr;
+    int oversamplingIndex = -1;
+
+    // Half-band filter ring-out beyond their latency, in host samples
+    static constexpr int oversamplingTailMargin = 64;
+
+    // Host samples of silent input seen so far, so skipping waits for the tail
+    juce::int64 silentSamples = 0;
+    bool skipping = false;
+
+    int maxBlockSize = 0;
+    double sampleRate = 44100.0;
+
+    // Smoothers run at the shaper's (possibly oversampled) rate. Range spans
+    // four decades so it ramps multiplicatively, which can't reach zero.
+    static constexpr double smoothingTimeSeconds = 0.02;
+    static constexpr float minimumSmoothedRange = 1.0e-3f;
+    juce::SmoothedValue<SampleType> driveSmoother, blendSmoother, volumeSmoother;
+    juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative> rangeSmoother;
+    float targets[numAutomatedParameters] = {};
+
+    enum { gainRamp, blendRamp, volumeRamp, numRamps };
+    juce::AudioBuffer<SampleType> ramps;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DistortionEngine)
+};
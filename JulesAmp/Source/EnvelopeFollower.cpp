@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "EnvelopeFollower.h"
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::prepare (double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax (1, maximumBlockSize);
+    amounts.allocate ((size_t) maxBlockSize, true);
+    driveMultipliers.allocate ((size_t) maxBlockSize, true);
+    blendMultipliers.allocate ((size_t) maxBlockSize, true);
+
+    updateCoefficients();
+    reset();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::reset() noexcept
+{
+    envelope = 0;
+    lastAmount = 0;
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setParameters (float newDepth, float newDuck, float newAttackMs, float newReleaseMs, bool rms) noexcept
+{
+    const auto wasActive = isActive();
+    depth = juce::jlimit (-1.0f, 1.0f, newDepth);
+    duck = juce::jlimit (0.0f, 1.0f, newDuck);
+    useRms = rms;
+
+    // Switching on starts from silence rather than whatever was left over
+    if (isActive() && ! wasActive)
+        reset();
+
+    // The exp() only runs when a time actually moves
+    if (newAttackMs != attackMs || newReleaseMs != releaseMs)
+    {
+        attackMs = newAttackMs;
+        releaseMs = newReleaseMs;
+        updateCoefficients();
+    }
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::updateCoefficients() noexcept
+{
+    // One-pole coefficients for a whole hop
+    auto hopCoefficient = [this] (float ms)
+    {
+        return (SampleType) std::exp (-(double) hopSize / (juce::jmax (0.01, (double) ms) * 0.001 * sampleRate));
+    };
+
+    attackCoefficient = hopCoefficient (attackMs);
+    releaseCoefficient = hopCoefficient (releaseMs);
+}
+
+template <typename SampleType>
+SampleType EnvelopeFollower<SampleType>::getMaximumMultiplier() const noexcept
+{
+    return (SampleType) juce::jmax (1.0f, 1.0f - depth);
+}
+
+template <typename SampleType>
+SampleType EnvelopeFollower<SampleType>::getAmount (SampleType level) noexcept
+{
+    // 0 at the floor, 1 at full scale, linear in dB in between
+    auto db = level > 0 ? 20.0 * std::log10 ((double) level) : floorDb;
+    return (SampleType) juce::jlimit (0.0, 1.0, (db - floorDb) / -floorDb);
+}
+
+//==============================================================================
+template <typename SampleType>
+SampleType EnvelopeFollower<SampleType>::measure (const juce::dsp::AudioBlock<const SampleType>& hop) const noexcept
+{
+    const auto numSamples = (int) hop.getNumSamples();
+    const auto numChannels = (int) hop.getNumChannels();
+
+    if (! useRms)
+    {
+        SampleType peak = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax (hop.getChannelPointer ((size_t) channel), numSamples);
+            peak = juce::jmax (peak, -range.getStart(), range.getEnd());
+        }
+
+        return peak;
+    }
+
+    // Independent partial sums so the loop vectorises without reassociation
+    SampleType sums[4] = {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* data = hop.getChannelPointer ((size_t) channel);
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+            for (int lane = 0; lane < 4; ++lane)
+                sums[lane] += data[i + lane] * data[i + lane];
+
+        for (; i < numSamples; ++i)
+            sums[0] += data[i] * data[i];
+    }
+
+    auto meanSquare = (sums[0] + sums[1] + sums[2] + sums[3]) / (SampleType) (numSamples * numChannels);
+    return std::sqrt (meanSquare);
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::process (const juce::dsp::AudioBlock<const SampleType>& key) noexcept
+{
+    const auto numSamples = juce::jmin ((int) key.getNumSamples(), maxBlockSize);
+
+    jassert ((int) key.getNumSamples() <= maxBlockSize);
+
+    for (int start = 0; start < numSamples; start += hopSize)
+    {
+        const auto length = juce::jmin (hopSize, numSamples - start);
+        const auto level = measure (key.getSubBlock ((size_t) start, (size_t) length));
+
+        auto coefficient = level > envelope ? attackCoefficient : releaseCoefficient;
+
+        // A short hop at the end of a sub-block only decays part of the way
+        if (length != hopSize)
+            coefficient = (SampleType) std::pow ((double) coefficient, (double) length / hopSize);
+
+        envelope = level + (envelope - level) * coefficient;
+
+        // The level ramps linearly across the hop towards the new value
+        const auto target = getAmount (envelope);
+        const auto step = (target - lastAmount) / (SampleType) length;
+        auto* dest = amounts.get() + start;
+
+        for (int i = 0; i < length; ++i)
+            dest[i] = lastAmount + step * (SampleType) (i + 1);
+
+        lastAmount = target;
+    }
+
+    // drive: 1 + depth * (amount - 1), blend: 1 - duck * amount
+    if (depth != 0)
+    {
+        juce::FloatVectorOperations::multiply (driveMultipliers.get(), amounts.get(), (SampleType) depth, numSamples);
+        juce::FloatVectorOperations::add (driveMultipliers.get(), (SampleType) (1 - depth), numSamples);
+    }
+
+    if (duck != 0)
+    {
+        juce::FloatVectorOperations::multiply (blendMultipliers.get(), amounts.get(), (SampleType) -duck, numSamples);
+        juce::FloatVectorOperations::add (blendMultipliers.get(), (SampleType) 1, numSamples);
+    }
+}
+
+template class EnvelopeFollower<float>;
+template class EnvelopeFollower<double>;
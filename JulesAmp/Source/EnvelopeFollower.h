@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    EnvelopeFollower.h
+    Created: 17 Oct 2026
+
+    Level detector that makes Drive follow the playing dynamics, and can
+    duck Blend from a key signal. The key is measured in short hops, one
+    vectorised peak or RMS pass over every channel per hop. Attack and
+    release run once per hop rather than once per sample, and the level is
+    interpolated linearly across each hop. The shaper gets smooth per-sample
+    curves for the cost of a few operations per hop.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <typename SampleType>
+class EnvelopeFollower
+{
+public:
+    /** Samples per detector hop, at the host rate. */
+    static constexpr int hopSize = 32;
+
+    /** Levels at or below this count as silence. */
+    static constexpr double floorDb = -48.0;
+
+    EnvelopeFollower() = default;
+
+    void prepare (double sampleRate, int maximumBlockSize);
+    void reset() noexcept;
+
+    /** depth in -1..1: positive cleans up as the input gets quieter, down to
+        (1 - depth) times the drive at the floor. Negative does the opposite,
+        pushing quiet passages up to twice the drive. duck in 0..1 pulls Blend
+        towards dry as the key gets louder, down to (1 - duck) times Blend at
+        full scale. Both 0 switches the follower off.
+    */
+    void setParameters (float depth, float duck, float attackMs, float releaseMs, bool rms) noexcept;
+
+    bool isActive() const noexcept              { return depth != 0 || duck != 0; }
+
+    /** The largest drive multiplier process() can produce with these settings. */
+    SampleType getMaximumMultiplier() const noexcept;
+
+    /** Measures key and fills the per-sample multipliers for its length.
+        key must fit the prepared size.
+    */
+    void process (const juce::dsp::AudioBlock<const SampleType>& key) noexcept;
+
+    /** The multipliers from the last process() call, null when that curve is off. */
+    const SampleType* getDriveMultipliers() const noexcept  { return depth != 0 ? driveMultipliers.get() : nullptr; }
+    const SampleType* getBlendMultipliers() const noexcept  { return duck != 0 ? blendMultipliers.get() : nullptr; }
+
+private:
+    void updateCoefficients() noexcept;
+    SampleType measure (const juce::dsp::AudioBlock<const SampleType>&) const noexcept;
+    static SampleType getAmount (SampleType envelope) noexcept;
+
+    double sampleRate = 44100.0;
+    float depth = 0, duck = 0, attackMs = 0, releaseMs = 0;
+    bool useRms = false;
+
+    SampleType attackCoefficient = 0, releaseCoefficient = 0;
+    SampleType envelope = 0, lastAmount = 0;
+
+    // amounts holds the level curve, 0 at the floor and 1 at full scale;
+    // both multipliers are linear in it.
+    juce::HeapBlock<SampleType> amounts, driveMultipliers, blendMultipliers;
+    int maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EnvelopeFollower)
+};
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    LevelMeter.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+LevelMeter::LevelMeter()
+{
+    frames.allocate ((size_t) capacity, true);
+}
+
+void LevelMeter::prepare (int maximumBlockSize)
+{
+    // Some hosts overshoot the block size they announced, and windows are
+    // small, so leave plenty of room. A block can also start and end
+    // mid-frame, hence the two extra.
+    maxWindows = juce::jmax (maximumBlockSize, 16384) / samplesPerFrame + 2;
+    inputWindows.allocate ((size_t) maxWindows, true);
+    numInputWindows = 0;
+
+    pendingInput = {};
+    pendingOutput = {};
+    pendingSamples = 0;
+}
+
+//==============================================================================
+void LevelMeter::Window::add (const Window& other) noexcept
+{
+    if (other.count == 0)
+        return;
+
+    min = count > 0 ? juce::jmin (min, other.min) : other.min;
+    max = count > 0 ? juce::jmax (max, other.max) : other.max;
+    sumSquares += other.sumSquares;
+    count += other.count;
+}
+
+template <typename SampleType>
+LevelMeter::Window LevelMeter::measure (const juce::dsp::AudioBlock<SampleType>& block, int start, int length) noexcept
+{
+    Window window;
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        const auto* data = block.getChannelPointer (channel) + start;
+        const auto range = juce::FloatVectorOperations::findMinAndMax (data, length);
+
+        // Independent partial sums so the loop vectorises without reassociation
+        SampleType sums[4] = {};
+        int i = 0;
+
+        for (; i + 4 <= length; i += 4)
+            for (int lane = 0; lane < 4; ++lane)
+                sums[lane] += data[i + lane] * data[i + lane];
+
+        for (; i < length; ++i)
+            sums[0] += data[i] * data[i];
+
+        window.add ({ (float) range.getStart(), (float) range.getEnd(),
+                      (float) (sums[0] + sums[1] + sums[2] + sums[3]), length });
+    }
+
+    return window;
+}
+
+//==============================================================================
+template <typename SampleType>
+void LevelMeter::measureInput (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    const auto numSamples = (int) block.getNumSamples();
+    auto filled = pendingSamples;
+    numInputWindows = 0;
+
+    for (int start = 0; start < numSamples;)
+    {
+        const auto length = juce::jmin (samplesPerFrame - filled, numSamples - start);
+
+        // Far beyond the announced block size: leave this block unmetered
+        if (numInputWindows == maxWindows)
+        {
+            numInputWindows = -1;
+            return;
+        }
+
+        inputWindows[numInputWindows++] = measure (block, start, length);
+        filled = (filled + length) % samplesPerFrame;
+        start += length;
+    }
+}
+
+template <typename SampleType>
+void LevelMeter::measureOutput (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+{
+    if (numInputWindows < 0)
+        return;
+
+    const auto numSamples = (int) block.getNumSamples();
+    int window = 0;
+
+    // Same windows as measureInput, which started from the same pendingSamples
+    for (int start = 0; start < numSamples && window < numInputWindows; ++window)
+    {
+        const auto length = juce::jmin (samplesPerFrame - pendingSamples, numSamples - start);
+
+        pendingInput.add (inputWindows[window]);
+        pendingOutput.add (measure (block, start, length));
+        pendingSamples += length;
+        start += length;
+
+        if (pendingSamples == samplesPerFrame)
+        {
+            push ({ pendingInput.min, pendingInput.max, pendingInput.sumSquares / (float) juce::jmax (1, pendingInput.count),
+                    pendingOutput.min, pendingOutput.max, pendingOutput.sumSquares / (float) juce::jmax (1, pendingOutput.count) });
+
+            pendingInput = {};
+            pendingOutput = {};
+            pendingSamples = 0;
+        }
+    }
+}
+
+//==============================================================================
+void LevelMeter::push (const Frame& frame) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    // Full: the editor is closed or stalled, and the scope can do without
+    if (size1 + size2 == 0)
+        return;
+
+    frames[size1 > 0 ? start1 : start2] = frame;
+    fifo.finishedWrite (1);
+}
+
+int LevelMeter::pop (Frame* dest, int maxFrames) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (maxFrames, start1, size1, start2, size2);
+
+    std::copy (frames.get() + start1, frames.get() + start1 + size1, dest);
+    std::copy (frames.get() + start2, frames.get() + start2 + size2, dest + size1);
+
+    fifo.finishedRead (size1 + size2);
+    return size1 + size2;
+}
+
+template void LevelMeter::measureInput (const juce::dsp::AudioBlock<float>&) noexcept;
+template void LevelMeter::measureInput (const juce::dsp::AudioBlock<double>&) noexcept;
+template void LevelMeter::measureOutput (const juce::dsp::AudioBlock<float>&) noexcept;
+template void LevelMeter::measureOutput (const juce::dsp::AudioBlock<double>&) noexcept;
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    LevelMeter.h
+    Created: 17 Oct 2026
+
+    Feeds the editor's meters and scope from the audio thread. Input and
+    output are reduced to one frame per samplesPerFrame samples: min, max and
+    mean square over every channel, a handful of vectorised passes per block.
+    Frames go through a wait-free single-producer/single-consumer FIFO. When
+    nobody drains it, new frames are dropped rather than waited on.
+
+    The output is paired with the input of the same samples, so a frame's
+    extremes trace the transfer curve, latency apart.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class LevelMeter
+{
+public:
+    /** Host-rate samples per frame, frames span callbacks. */
+    static constexpr int samplesPerFrame = 128;
+
+    /** Frames the FIFO holds, about a second at 96 kHz. */
+    static constexpr int capacity = 1024;
+
+    struct Frame
+    {
+        float inputMin, inputMax, inputMeanSquare;
+        float outputMin, outputMax, outputMeanSquare;
+    };
+
+    LevelMeter();
+
+    /** Before the audio thread starts. Drops any half-filled frame. */
+    void prepare (int maximumBlockSize);
+
+    /** Audio thread, on the block before it's processed in place. */
+    template <typename SampleType>
+    void measureInput (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+
+    /** Audio thread, on the same block once it's processed. Pushes every frame it completes. */
+    template <typename SampleType>
+    void measureOutput (const juce::dsp::AudioBlock<SampleType>&) noexcept;
+
+    /** Consumer side: copies out up to maxFrames of the oldest frames, returns how many. */
+    int pop (Frame* dest, int maxFrames) noexcept;
+
+private:
+    struct Window
+    {
+        float min = 0, max = 0, sumSquares = 0;
+        int count = 0;      // samples times channels
+
+        void add (const Window&) noexcept;
+    };
+
+    template <typename SampleType>
+    static Window measure (const juce::dsp::AudioBlock<SampleType>&, int start, int length) noexcept;
+
+    void push (const Frame&) noexcept;
+
+    juce::AbstractFifo fifo { capacity };
+    juce::HeapBlock<Frame> frames;
+
+    // Input windows of the current block, waiting for their output
+    juce::HeapBlock<Window> inputWindows;
+    int maxWindows = 0, numInputWindows = 0;
+
+    // The frame still filling up, carried over from callback to callback
+    Window pendingInput, pendingOutput;
+    int pendingSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    MeterDisplay.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "MeterDisplay.h"
+
+namespace
+{
+    constexpr float floorDb = -60.0f;
+
+    const juce::Colour backgroundColour = juce::Colours::black.withAlpha (0.4f);
+    const juce::Colour inputColour (185u, 108u, 255u);
+    const juce::Colour outputColour (170u, 253u, 237u);
+}
+
+MeterDisplay::MeterDisplay (LevelMeter& m)
+    : meter (m)
+{
+    setInterceptsMouseClicks (false, false);
+}
+
+void MeterDisplay::update()
+{
+    const auto numFrames = meter.pop (incoming, LevelMeter::capacity);
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto elapsed = (float) juce::jlimit (0.0, 1.0, (now - lastUpdateMs) * 0.001);
+    lastUpdateMs = now;
+
+    Levels newInput, newOutput;
+    double inputSquares = 0, outputSquares = 0;
+
+    for (int i = 0; i < numFrames; ++i)
+    {
+        const auto& frame = incoming[i];
+
+        newInput.peak = juce::jmax (newInput.peak, -frame.inputMin, frame.inputMax);
+        newOutput.peak = juce::jmax (newOutput.peak, -frame.outputMin, frame.outputMax);
+        inputSquares += frame.inputMeanSquare;
+        outputSquares += frame.outputMeanSquare;
+
+        history[historyEnd] = frame;
+        historyEnd = (historyEnd + 1) % historySize;
+    }
+
+    if (numFrames > 0)
+    {
+        newInput.rms = (float) std::sqrt (inputSquares / numFrames);
+        newOutput.rms = (float) std::sqrt (outputSquares / numFrames);
+    }
+
+    // Peaks hold and fall at 20 dB/s, RMS follows the latest frames and
+    // falls the same way once they stop coming
+    const auto fall = std::pow (10.0f, -elapsed);
+    const auto wasVisible = input.peak > 0 || output.peak > 0;
+
+    auto fallTowards = [numFrames, fall] (Levels& shown, const Levels& latest)
+    {
+        shown.peak = juce::jmax (latest.peak, shown.peak * fall);
+        shown.rms = numFrames > 0 ? latest.rms : shown.rms * fall;
+
+        if (juce::Decibels::gainToDecibels (shown.peak) < floorDb)
+            shown = {};
+    };
+
+    fallTowards (input, newInput);
+    fallTowards (output, newOutput);
+
+    if (newInput.rms > 0 && newOutput.rms > 0 && newOutput.peak > 0)
+        crestReduction = juce::Decibels::gainToDecibels ((newInput.peak / newInput.rms) / (newOutput.peak / newOutput.rms));
+
+    // Nothing new and the meters are already down: leave the pixels alone
+    if (numFrames > 0 || wasVisible)
+        repaint();
+}
+
+//==============================================================================
+void MeterDisplay::paint (juce::Graphics& g)
+{
+    drawEnvelope (g, envelopeArea);
+    drawTransfer (g, transferArea);
+
+    drawMeter (g, inputMeterArea, input);
+    drawMeter (g, outputMeterArea, output);
+
+    g.setColour (outputColour);
+    g.setFont (readoutFont);
+    g.drawText ("Clip " + juce::String (juce::jmax (0.0f, crestReduction), 1) + " dB", readoutArea, juce::Justification::centredRight, false);
+}
+
+void MeterDisplay::resized()
+{
+    // Proportions of the default editor size, where this is about 180 px tall
+    const auto scale = getHeight() / 180.0f;
+    auto bounds = getLocalBounds().toFloat();
+
+    readoutArea = bounds.removeFromBottom (14.0f * scale);
+    readoutFont = juce::Font (12.0f * scale);
+
+    auto meters = bounds.removeFromRight (32.0f * scale);
+    inputMeterArea = meters.removeFromLeft (meters.getWidth() * 0.5f).reduced (2.0f * scale, 0.0f);
+    outputMeterArea = meters.reduced (2.0f * scale, 0.0f);
+    bounds.removeFromRight (4.0f * scale);
+
+    envelopeArea = bounds.removeFromLeft (bounds.getWidth() * 0.5f).reduced (2.0f * scale);
+
+    auto side = juce::jmax (1.0f, juce::jmin (bounds.getWidth(), bounds.getHeight()) - 4.0f * scale);
+    transferArea = bounds.withSizeKeepingCentre (side, side);
+    dotSize = juce::jmax (1.0f, 2.0f * scale);
+}
+
+void MeterDisplay::drawMeter (juce::Graphics& g, juce::Rectangle<float> area, const Levels& levels) const
+{
+    auto toY = [area] (float gain)
+    {
+        return juce::jmap (juce::Decibels::gainToDecibels (gain, floorDb), floorDb, 0.0f, area.getBottom(), area.getY());
+    };
+
+    g.setColour (backgroundColour);
+    g.fillRect (area);
+
+    g.setColour (outputColour);
+    g.fillRect (area.withTop (toY (levels.rms)));
+
+    // Red once the peak reaches full scale
+    g.setColour (levels.peak >= 1.0f ? juce::Colours::red : inputColour);
+    g.fillRect (area.getX(), toY (levels.peak) - 1.0f, area.getWidth(), 2.0f);
+}
+
+void MeterDisplay::drawEnvelope (juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    g.setColour (backgroundColour);
+    g.fillRect (area);
+
+    // One column per pixel, each covering every frame that lands on it
+    const auto numColumns = juce::jmax (1, (int) area.getWidth());
+    const auto centre = area.getCentreY();
+    const auto halfHeight = area.getHeight() * 0.5f;
+    juce::RectangleList<float> inputColumns, outputColumns;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto first = column * historySize / numColumns;
+        const auto last = juce::jmax (first + 1, (column + 1) * historySize / numColumns);
+        auto frame = history[(historyEnd + first) % historySize];
+
+        for (int i = first + 1; i < last; ++i)
+        {
+            const auto& next = history[(historyEnd + i) % historySize];
+            frame.inputMin = juce::jmin (frame.inputMin, next.inputMin);
+            frame.inputMax = juce::jmax (frame.inputMax, next.inputMax);
+            frame.outputMin = juce::jmin (frame.outputMin, next.outputMin);
+            frame.outputMax = juce::jmax (frame.outputMax, next.outputMax);
+        }
+
+        auto addColumn = [&] (juce::RectangleList<float>& list, float min, float max)
+        {
+            const auto top = centre - juce::jlimit (-1.0f, 1.0f, max) * halfHeight;
+            const auto bottom = centre - juce::jlimit (-1.0f, 1.0f, min) * halfHeight;
+            list.addWithoutMerging ({ area.getX() + (float) column, top, 1.0f, juce::jmax (1.0f, bottom - top) });
+        };
+
+        addColumn (inputColumns, frame.inputMin, frame.inputMax);
+        addColumn (outputColumns, frame.outputMin, frame.outputMax);
+    }
+
+    g.setColour (inputColour.withAlpha (0.4f));
+    g.fillRectList (inputColumns);
+
+    g.setColour (outputColour);
+    g.fillRectList (outputColumns);
+}
+
+void MeterDisplay::drawTransfer (juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    g.setColour (backgroundColour);
+    g.fillRect (area);
+
+    // Unity for reference: anything off it is the shaper at work
+    g.setColour (inputColour.withAlpha (0.4f));
+    g.drawLine (area.getX(), area.getBottom(), area.getRight(), area.getY(), 1.0f);
+
+    auto toPoint = [area] (float in, float out)
+    {
+        return juce::Point<float> (juce::jmap (juce::jlimit (-1.0f, 1.0f, in), -1.0f, 1.0f, area.getX(), area.getRight()),
+                                   juce::jmap (juce::jlimit (-1.0f, 1.0f, out), -1.0f, 1.0f, area.getBottom(), area.getY()));
+    };
+
+    juce::RectangleList<float> points;
+
+    for (const auto& frame : history)
+    {
+        // Both extremes of every frame, the silent ones all land on the origin
+        points.addWithoutMerging (juce::Rectangle<float> (dotSize, dotSize).withCentre (toPoint (frame.inputMax, frame.outputMax)));
+        points.addWithoutMerging (juce::Rectangle<float> (dotSize, dotSize).withCentre (toPoint (frame.inputMin, frame.outputMin)));
+    }
+
+    g.setColour (outputColour);
+    g.fillRectList (points);
+}
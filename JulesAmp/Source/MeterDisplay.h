@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    MeterDisplay.h
+    Created: 17 Oct 2026
+
+    Input/output peak and RMS meters, a clipping readout and a scope, drawn
+    from LevelMeter frames. The editor calls update() from its frame timer,
+    which drains the FIFO without ever making the audio thread wait.
+
+    The scope has two views side by side: the output envelope over the last
+    historySize frames, and the transfer curve the signal is actually taking,
+    each frame's input extremes plotted against its output extremes.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "LevelMeter.h"
+
+class MeterDisplay  : public juce::Component
+{
+public:
+    /** Frames kept for the scope, a little over a second at 48 kHz. */
+    static constexpr int historySize = 512;
+
+    explicit MeterDisplay (LevelMeter&);
+
+    /** Message thread. Drains the meter and repaints if anything arrived. */
+    void update();
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    struct Levels
+    {
+        float peak = 0, rms = 0;
+    };
+
+    void drawMeter (juce::Graphics&, juce::Rectangle<float>, const Levels&) const;
+    void drawEnvelope (juce::Graphics&, juce::Rectangle<float>) const;
+    void drawTransfer (juce::Graphics&, juce::Rectangle<float>) const;
+
+    LevelMeter& meter;
+
+    // Laid out in resized(), everything scales with the component's height
+    juce::Rectangle<float> envelopeArea, transferArea, inputMeterArea, outputMeterArea, readoutArea;
+    juce::Font readoutFont;
+    float dotSize = 2.0f;
+
+    LevelMeter::Frame incoming[LevelMeter::capacity];
+    LevelMeter::Frame history[historySize] = {};
+    int historyEnd = 0;     // one past the newest frame
+
+    Levels input, output;
+    double lastUpdateMs = 0;
+
+    // Crest factor lost between input and output, in dB: how hard it's clipping
+    float crestReduction = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterDisplay)
+};
@@ -0,0 +1,287 @@
+/*
+  ==============================================================================
+
+    MultibandShaper.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "MultibandShaper.h"
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::prepare (double newHostSampleRate, int maxOversamplingOrder, int maxBlockSize, int newNumChannels)
+{
+    hostSampleRate = newHostSampleRate;
+    numChannels = juce::jmax (1, newNumChannels);
+
+    auto maxShaperBlockSize = maxBlockSize << maxOversamplingOrder;
+
+    for (auto& buffer : bandBuffers)
+        buffer.setSize (numChannels, maxShaperBlockSize);
+
+    ramps.setSize (numRamps, maxShaperBlockSize);
+    juce::FloatVectorOperations::fill (ramps.getWritePointer (unityRamp), (SampleType) 1, maxShaperBlockSize);
+
+    for (int rate = 0; rate < maxRates && rate <= maxOversamplingOrder; ++rate)
+    {
+        auto& set = filterSets[rate];
+        set.sampleRate = hostSampleRate * (double) (1 << rate);
+
+        juce::dsp::ProcessSpec spec { set.sampleRate, (juce::uint32) maxShaperBlockSize, (juce::uint32) numChannels };
+
+        for (auto& crossover : set.splits)
+            crossover.prepare (spec);
+
+        for (auto& row : set.allpasses)
+        {
+            for (auto& allpass : row)
+            {
+                allpass.setType (Crossover::Type::allpass);
+                allpass.prepare (spec);
+            }
+        }
+    }
+
+    crossoversChanged = true;
+    setOversamplingOrder (0);
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::setOversamplingOrder (int newOrder) noexcept
+{
+    order = juce::jlimit (0, maxRates - 1, newOrder);
+
+    auto& set = filterSets[order];
+
+    for (auto& crossover : set.splits)
+        crossover.reset();
+
+    for (auto& row : set.allpasses)
+        for (auto& allpass : row)
+            allpass.reset();
+
+    crossoversChanged = true;
+    resetSmoothers();
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::setNumBands (int newNumBands) noexcept
+{
+    newNumBands = juce::jlimit (1, maxBands, newNumBands);
+
+    if (newNumBands == numBands)
+        return;
+
+    // Freshly enabled crossovers start from silence rather than stale state
+    numBands = newNumBands;
+    setOversamplingOrder (order);
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::setCrossover (int index, float frequency) noexcept
+{
+    if (juce::isPositiveAndBelow (index, maxBands - 1) && crossovers[index] != frequency)
+    {
+        crossovers[index] = frequency;
+        crossoversChanged = true;
+    }
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::updateCrossovers (FilterSet& set) noexcept
+{
+    // The LR filters prewarp with tan(), keep well clear of Nyquist
+    const auto maxFrequency = (SampleType) (hostSampleRate * 0.45);
+    SampleType previous = 10;
+
+    for (int i = 0; i < maxBands - 1; ++i)
+    {
+        auto frequency = juce::jlimit (previous, maxFrequency, (SampleType) crossovers[i]);
+        previous = frequency;
+
+        set.splits[i].setCutoffFrequency (frequency);
+
+        for (int band = 0; band < i; ++band)
+            set.allpasses[band][i].setCutoffFrequency (frequency);
+    }
+
+    crossoversChanged = false;
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandShaper<SampleType>::setTarget (int band, int parameter, float value) noexcept
+{
+    if (! juce::isPositiveAndBelow (band, maxBands) || ! juce::isPositiveAndBelow (parameter, (int) numBandParameters))
+        return;
+
+    auto& b = bands[band];
+    b.targets[parameter] = value;
+
+    switch (parameter)
+    {
+        case bandDrive: b.drive.setTargetValue ((SampleType) value); break;
+        case bandRange: b.range.setTargetValue ((SampleType) juce::jmax (minimumSmoothedRange, value)); break;
+        case bandBlend: b.blend.setTargetValue ((SampleType) value); break;
+        default: break;
+    }
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::resetSmoothers() noexcept
+{
+    auto shaperSampleRate = hostSampleRate * (double) (1 << order);
+
+    for (auto& b : bands)
+    {
+        b.drive.reset (shaperSampleRate, smoothingTimeSeconds);
+        b.range.reset (shaperSampleRate, smoothingTimeSeconds);
+        b.blend.reset (shaperSampleRate, smoothingTimeSeconds);
+
+        b.drive.setCurrentAndTargetValue ((SampleType) b.targets[bandDrive]);
+        b.range.setCurrentAndTargetValue ((SampleType) juce::jmax (minimumSmoothedRange, b.targets[bandRange]));
+        b.blend.setCurrentAndTargetValue ((SampleType) b.targets[bandBlend]);
+    }
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::skipSmoothers (int numSamples, int firstBand) noexcept
+{
+    for (int band = firstBand; band < maxBands; ++band)
+    {
+        bands[band].drive.skip (numSamples);
+        bands[band].range.skip (numSamples);
+        bands[band].blend.skip (numSamples);
+    }
+}
+
+template <typename SampleType>
+bool MultibandShaper<SampleType>::isSmoothing (int band) const noexcept
+{
+    auto& b = bands[band];
+    return b.drive.isSmoothing() || b.range.isSmoothing() || b.blend.isSmoothing();
+}
+
+template <typename SampleType>
+SampleType MultibandShaper<SampleType>::getMaximumGain() const noexcept
+{
+    auto bound = [] (const auto& smoother) { return juce::jmax (smoother.getCurrentValue(), smoother.getTargetValue()); };
+    SampleType gain = 0;
+
+    for (int band = 0; band < numBands; ++band)
+        gain = juce::jmax (gain, bound (bands[band].drive) * bound (bands[band].range));
+
+    return gain;
+}
+
+template <typename SampleType>
+int MultibandShaper<SampleType>::getTailLengthSamples() const noexcept
+{
+    // A few periods of the lowest crossover covers the filters' decay
+    return numBands > 1 ? juce::roundToInt (4.0 * hostSampleRate / juce::jmax (10.0f, crossovers[0])) : 0;
+}
+
+//==============================================================================
+template <typename SampleType>
+void MultibandShaper<SampleType>::split (const juce::dsp::AudioBlock<SampleType>& block, FilterSet& set) noexcept
+{
+    const auto numSamples = (int) block.getNumSamples();
+    const auto lastBand = numBands - 1;
+
+    for (int channel = 0; channel < (int) block.getNumChannels(); ++channel)
+    {
+        const auto* input = block.getChannelPointer ((size_t) channel);
+        SampleType* out[maxBands];
+
+        for (int band = 0; band < numBands; ++band)
+            out[band] = bandBuffers[band].getWritePointer (channel);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto x = input[i];
+
+            for (int band = 0; band < lastBand; ++band)
+            {
+                SampleType low, high;
+                set.splits[band].processSample (channel, x, low, high);
+
+                // Match the phase of the bands split off further up
+                for (int crossover = band + 1; crossover < lastBand; ++crossover)
+                    low = set.allpasses[band][crossover].processSample (channel, low);
+
+                out[band][i] = low;
+                x = high;
+            }
+
+            out[lastBand][i] = x;
+        }
+    }
+}
+
+template <typename SampleType>
+void MultibandShaper<SampleType>::process (const juce::dsp::AudioBlock<SampleType>& block, Waveshaper<SampleType>& waveshaper,
+                                           const SampleType* driveModulation, const SampleType* blendModulation,
+                                           int modulationShift) noexcept
+{
+    const auto numSamples = (int) block.getNumSamples();
+    const auto channels = juce::jmin ((int) block.getNumChannels(), numChannels);
+
+    jassert (numSamples <= ramps.getNumSamples());
+
+    auto& set = filterSets[order];
+
+    if (crossoversChanged)
+        updateCrossovers (set);
+
+    split (block, set);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto* const* data = bandBuffers[band].getArrayOfWritePointers();
+        auto& b = bands[band];
+
+        // Each band is shaped with the same kernels as the full-band path,
+        // vectorised along time over every channel in one call.
+        if (! isSmoothing (band) && driveModulation == nullptr && blendModulation == nullptr)
+        {
+            waveshaper.process (data, channels, numSamples, b.drive.getCurrentValue() * b.range.getCurrentValue(),
+                                b.blend.getCurrentValue(), (SampleType) 1);
+            continue;
+        }
+
+        auto* gain = ramps.getWritePointer (gainRamp);
+        auto* blend = ramps.getWritePointer (blendRamp);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            gain[i] = b.drive.getNextValue() * b.range.getNextValue();
+            blend[i] = b.blend.getNextValue();
+        }
+
+        if (driveModulation != nullptr)
+            for (int i = 0; i < numSamples; ++i)
+                gain[i] *= driveModulation[i >> modulationShift];
+
+        if (blendModulation != nullptr)
+            for (int i = 0; i < numSamples; ++i)
+                blend[i] *= blendModulation[i >> modulationShift];
+
+        waveshaper.processRamped (data, channels, numSamples, gain, blend, ramps.getReadPointer (unityRamp));
+    }
+
+    // Inactive bands' smoothers keep time, so enabling them later doesn't glide from stale values
+    skipSmoothers (numSamples, numBands);
+
+    for (int channel = 0; channel < channels; ++channel)
+    {
+        auto* output = block.getChannelPointer ((size_t) channel);
+        juce::FloatVectorOperations::copy (output, bandBuffers[0].getReadPointer (channel), numSamples);
+
+        for (int band = 1; band < numBands; ++band)
+            juce::FloatVectorOperations::add (output, bandBuffers[band].getReadPointer (channel), numSamples);
+    }
+}
+
+template class MultibandShaper<float>;
+template class MultibandShaper<double>;
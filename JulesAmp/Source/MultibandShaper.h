@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    MultibandShaper.h
+    Created: 17 Oct 2026
+
+    Optional 2 to 4 band mode for the shaper. Linkwitz-Riley crossovers split
+    the (possibly oversampled) signal into band scratch buffers, each band is
+    shaped with its own Drive/Range/Blend and the bands are summed back.
+    Lower bands go through allpasses at the higher crossover frequencies, so
+    with the shaper at unity the bands add back to a flat response.
+
+    Volume isn't applied here: the curve is linear in it, so the engine
+    scales the summed output once.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Waveshaper.h"
+
+template <typename SampleType>
+class MultibandShaper
+{
+public:
+    static constexpr int maxBands = 4;
+
+    enum BandParameter
+    {
+        bandDrive,
+        bandRange,
+        bandBlend,
+        numBandParameters
+    };
+
+    MultibandShaper() = default;
+
+    /** Sizes the band buffers for the largest block at the highest shaper
+        rate, and prepares one set of crossovers per oversampling factor so
+        switching factor never allocates.
+    */
+    void prepare (double hostSampleRate, int maxOversamplingOrder, int maxBlockSize, int numChannels);
+
+    /** Picks the crossover set and smoother rate for the current oversampling order. */
+    void setOversamplingOrder (int order) noexcept;
+
+    /** 1 turns the multiband path off. */
+    void setNumBands (int numBands) noexcept;
+    int getNumBands() const noexcept                { return numBands; }
+
+    /** index 0 is the lowest crossover. Kept ascending and below Nyquist. */
+    void setCrossover (int index, float frequency) noexcept;
+
+    void setTarget (int band, int parameter, float value) noexcept;
+    void resetSmoothers() noexcept;
+
+    /** Advances the smoothers of bands firstBand and up without processing. */
+    void skipSmoothers (int numSamples, int firstBand = 0) noexcept;
+
+    /** Largest drive * range any active band reaches during the next block. */
+    SampleType getMaximumGain() const noexcept;
+
+    /** How long the crossovers keep ringing, in host samples. */
+    int getTailLengthSamples() const noexcept;
+
+    /** Shapes in place at volume 1. block must fit the prepared size. Non-null
+        modulation curves scale every band's drive or blend by entry
+        i >> modulationShift for sample i.
+    */
+    void process (const juce::dsp::AudioBlock<SampleType>&, Waveshaper<SampleType>&,
+                  const SampleType* driveModulation = nullptr, const SampleType* blendModulation = nullptr,
+                  int modulationShift = 0) noexcept;
+
+private:
+    using Crossover = juce::dsp::LinkwitzRileyFilter<SampleType>;
+
+    struct FilterSet
+    {
+        Crossover splits[maxBands - 1];
+        Crossover allpasses[maxBands - 1][maxBands - 1];   // [band][crossover], only crossover > band is used
+        double sampleRate = 0;
+    };
+
+    void split (const juce::dsp::AudioBlock<SampleType>&, FilterSet&) noexcept;
+    void updateCrossovers (FilterSet&) noexcept;
+    bool isSmoothing (int band) const noexcept;
+
+    static constexpr int maxRates = 4; // 1x to 8x
+    FilterSet filterSets[maxRates];
+    int order = 0;
+
+    int numBands = 1;
+    int numChannels = 0;
+    double hostSampleRate = 44100.0;
+    float crossovers[maxBands - 1] = { 200.0f, 1000.0f, 5000.0f };
+    bool crossoversChanged = true;
+
+    struct Band
+    {
+        juce::SmoothedValue<SampleType> drive, blend;
+        juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative> range;
+        float targets[numBandParameters] = { 1.0f, 1.0f, 1.0f };
+    };
+
+    Band bands[maxBands];
+    juce::AudioBuffer<SampleType> bandBuffers[maxBands];
+
+    enum { gainRamp, blendRamp, unityRamp, numRamps };
+    juce::AudioBuffer<SampleType> ramps;
+
+    static constexpr double smoothingTimeSeconds = 0.02;
+    static constexpr float minimumSmoothedRange = 1.0e-3f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultibandShaper)
+};
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    ParameterEventQueue.h
+    Created: 17 Oct 2026
+
+    Single-producer/single-consumer FIFO of sample-timestamped parameter
+    changes. The producer (message thread, or an offline render driver) must
+    push events in timestamp order; the audio thread peeks at the head and
+    only pops once the render position has reached it.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class ParameterEventQueue
+{
+public:
+    struct Event
+    {
+        juce::int64 position;   // in samples since prepareToPlay, at the host rate
+        int parameter;
+        float value;
+    };
+
+    explicit ParameterEventQueue (int capacity = 1024)
+        : fifo (capacity)
+    {
+        events.allocate ((size_t) capacity, true);
+    }
+
+    /** Producer side. Returns false if the queue is full. */
+    bool push (const Event& event) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        events[size1 > 0 ? start1 : start2] = event;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /** Consumer side: the oldest pending event, or nullptr. */
+    const Event* peek() const noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return nullptr;
+
+        return &events[size1 > 0 ? start1 : start2];
+    }
+
+    void pop() noexcept     { fifo.finishedRead (1); }
+
+    /** Consumer side: drops everything pending. */
+    void clear() noexcept   { fifo.finishedRead (fifo.getNumReady()); }
+
+    /** The most events that can ever be pending at once. */
+    int getCapacity() const noexcept    { return fifo.getTotalSize() - 1; }
+
+private:
+    juce::AbstractFifo fifo;
+    juce::HeapBlock<Event> events;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterEventQueue)
+};
@@ -14,53 +14,100 @@ void LookAndFeel::drawRotarySlider(juce::Graphics& g,
     int y,
     int width,
     int height,
-    float sliderPosProportional,
-    float rotaryStartAngle,
-    float rotaryEndAngle,
-    juce::Slider& slider)
+    float /*sliderPosProportional*/,
+    float /*rotaryStartAngle*/,
+    float /*rotaryEndAngle*/,
+    juce::Slider& /*slider*/)
 {
-    using namespace juce;
+    // RotarySliderWithLabels paints through drawKnob, other sliders just get the body
+    auto bounds = juce::Rectangle<float>(x, y, width, height);
+    auto& body = getKnobBody(g, bounds, 0);
 
-    auto bounds = Rectangle<float>(x, y, width, height);
+    g.drawImageTransformed(body.image, juce::AffineTransform::scale(1.f / body.scale).translated(bounds.getPosition()));
+}
 
-    g.setColour(Colour(117u, 33u, 255u));
-    g.fillEllipse(bounds);
+void LookAndFeel::drawKnob(juce::Graphics& g,
+    juce::Rectangle<float> bounds,
+    float angle,
+    const juce::String& text,
+    float textWidth,
+    int textHeight)
+{
+    using namespace juce;
+
+    auto& body = getKnobBody(g, bounds, textHeight);
+    g.drawImageTransformed(body.image, AffineTransform::scale(1.f / body.scale).translated(bounds.getPosition()));
 
     g.setColour(Colour(170u, 253u, 237u));
-    g.drawEllipse(bounds, 1.f);
+    g.fillPath(body.pointer, AffineTransform::rotation(angle, bounds.getWidth() * 0.5f, bounds.getHeight() * 0.5f)
+                                             .translated(bounds.getPosition()));
 
-    if (auto* rswl = dynamic_cast<RotarySliderWithLabels*>(&slider))
-    {
-        auto center = bounds.getCentre();
+    Rectangle<float> r;
+    r.setSize(textWidth + 4, textHeight + 2);
+    r.setCentre(bounds.getCentre());
 
-        Path p;
+    g.setColour(Colours::black);
+    g.fillRect(r);
 
-        Rectangle<float> r;
-        r.setLeft(center.getX() - 2);
-        r.setRight(center.getX() + 2);
-        r.setTop(bounds.getY());
-        r.setBottom(center.getY() - rswl->getTextHeight() * 1.5);
+    g.setColour(Colours::white);
+    g.setFont((float) textHeight);
+    g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
+}
 
-        p.addRoundedRectangle(r, 2.f);
+const LookAndFeel::KnobBody& LookAndFeel::getKnobBody(juce::Graphics& g, juce::Rectangle<float> bounds, int textHeight)
+{
+    using namespace juce;
+
+    const auto width = roundToInt(bounds.getWidth());
+    const auto height = roundToInt(bounds.getHeight());
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-        jassert(rotaryStartAngle < rotaryEndAngle);
+    for (auto& body : knobBodies)
+        if (body.width == width && body.height == height && body.textHeight == textHeight && body.scale == scale)
+            return body;
 
-        auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
-        p.applyTransform(AffineTransform().rotated(sliderAngRad, center.getX(), center.getY()));
-        g.fillPath(p);
+    // Dragging a window corner walks through lots of sizes, don't keep them all
+    if (knobBodies.size() >= 16)
+        knobBodies.clear();
 
-        g.setFont(rswl->getTextHeight());
-        auto text = rswl->getDisplayString();
-        auto strWidth = g.getCurrentFont().getStringWidth(text);
-        r.setSize(strWidth + 4, rswl->getTextHeight() + 2);
-        r.setCentre(bounds.getCentre());
+    KnobBody body;
+    body.width = width;
+    body.height = height;
+    body.textHeight = textHeight;
+    body.scale = scale;
 
-        g.setColour(Colours::black);
-        g.fillRect(r);
+    // Rendered at the physical resolution so it stays sharp on HiDPI screens
+    body.image = Image(Image::ARGB, jmax(1, roundToInt(width * scale)), jmax(1, roundToInt(height * scale)), true);
 
-        g.setColour(Colours::white);
-        g.drawFittedText(text, r.toNearestInt(), juce::Justification::centred, 1);
+    {
+        Graphics ig(body.image);
+        ig.addTransform(AffineTransform::scale(scale));
+
+        auto local = Rectangle<float>(0, 0, (float) width, (float) height);
+
+        ig.setColour(Colour(117u, 33u, 255u));
+        ig.fillEllipse(local);
+
+        ig.setColour(Colour(170u, 253u, 237u));
+        ig.drawEllipse(local, 1.f);
     }
+
+    if (textHeight > 0)
+    {
+        // Pointing straight up, drawKnob rotates it into place
+        auto center = Point<float>(width * 0.5f, height * 0.5f);
+
+        Rectangle<float> r;
+        r.setLeft(center.getX() - 2);
+        r.setRight(center.getX() + 2);
+        r.setTop(0);
+        r.setBottom(center.getY() - textHeight * 1.5f);
+
+        body.pointer.addRoundedRectangle(r, 2.f);
+    }
+
+    knobBodies.push_back(std::move(body));
+    return knobBodies.back();
 }
 
 juce::String RotarySliderWithLabels::getDisplayString() const
@@ -88,7 +135,7 @@ juce::String RotarySliderWithLabels::getDisplayString() const
         jassertfalse; //this shouldn't happen!
     }
 
-    if (suffix.isNotEmpty())
+    if (suffix.isNotEmpty() || addK)
     {
         str << " ";
         if (addK)
@@ -102,65 +149,174 @@ juce::String RotarySliderWithLabels::getDisplayString() const
 
 void RotarySliderWithLabels::paint(juce::Graphics& g)
 {
+    auto rotary = getRotaryParameters();
 
-    auto startAng = juce::degreesToRadians(180.f + 45.f);
-    auto endAng = juce::degreesToRadians(180.f - 45.f) + juce::MathConstants<float>::twoPi;
+    jassert(rotary.startAngleRadians < rotary.endAngleRadians);
 
     auto range = getRange();
+    auto value = getValue();
 
-    auto sliderBounds = getSliderBounds();
+    if (value != displayedValue)
+    {
+        displayedValue = value;
+        displayText = getDisplayString();
+        displayTextWidth = (float) juce::Font((float) getTextHeight()).getStringWidth(displayText);
+    }
 
-    getLookAndFeel().drawRotarySlider(g,
-        sliderBounds.getX(),
-        sliderBounds.getY(),
-        sliderBounds.getWidth(),
-        sliderBounds.getHeight(),
-        juce::jmap(getValue(), range.getStart(), range.getEnd(), 0.0, 1.0),
-        startAng,
-        endAng,
-        *this);
+    auto sliderPosProportional = (float) juce::jmap(value, range.getStart(), range.getEnd(), 0.0, 1.0);
 
-    auto center = sliderBounds.toFloat().getCentre();
-    auto radius = sliderBounds.getWidth() * 0.5f;
+    lnf.drawKnob(g,
+        getSliderBounds().toFloat(),
+        juce::jmap(sliderPosProportional, 0.f, 1.f, rotary.startAngleRadians, rotary.endAngleRadians),
+        displayText,
+        displayTextWidth,
+        getTextHeight());
+}
 
-    g.setColour(juce::Colour(0u, 172u, 1u));
-    g.setFont(getTextHeight());
+void RotarySliderWithLabels::resized()
+{
+    auto bounds = getLocalBounds();
+    auto size = juce::jmin(bounds.getWidth(), bounds.getHeight());
 
+    sliderBounds = juce::Rectangle<int>(size, size).withCentre(bounds.getCentre());
+
+    // 14 px at the default layout's knob size
+    textHeight = juce::jlimit(9, 48, size * 14 / 150);
+
+    // The readout's width depends on the font, measure it again at the next paint
+    displayedValue = std::numeric_limits<double>::quiet_NaN();
 }
 
-juce::Rectangle<int> RotarySliderWithLabels::getSliderBounds() const
+//==============================================================================
+ThrottledSliderAttachment::ThrottledSliderAttachment(juce::RangedAudioParameter& p, juce::Slider& s)
+    : parameter(p), slider(s)
 {
-    return getLocalBounds();
+    // The slider maps exactly like the parameter, skew and snapping included
+    auto range = parameter.getNormalisableRange();
+
+    auto convertFrom0To1 = [range](double start, double end, double value) mutable
+    {
+        range.start = (float) start;
+        range.end = (float) end;
+        return (double) range.convertFrom0to1((float) value);
+    };
+
+    auto convertTo0To1 = [range](double start, double end, double value) mutable
+    {
+        range.start = (float) start;
+        range.end = (float) end;
+        return (double) range.convertTo0to1((float) value);
+    };
+
+    auto snapToLegalValue = [range](double start, double end, double value) mutable
+    {
+        range.start = (float) start;
+        range.end = (float) end;
+        return (double) range.snapToLegalValue((float) value);
+    };
+
+    juce::NormalisableRange<double> sliderRange((double) range.start, (double) range.end,
+                                                convertFrom0To1, convertTo0To1, snapToLegalValue);
+    sliderRange.interval = (double) range.interval;
+    sliderRange.skew = (double) range.skew;
+
+    slider.setNormalisableRange(sliderRange);
+    slider.setDoubleClickReturnValue(true, (double) parameter.convertFrom0to1(parameter.getDefaultValue()));
+
+    slider.onDragStart = [this]
+    {
+        dragging = true;
+        parameter.beginChangeGesture();
+    };
+
+    slider.onDragEnd = [this]
+    {
+        dragging = false;
+        parameter.endChangeGesture();
+    };
+
+    slider.onValueChange = [this]
+    {
+        // Clicks, wheel and keys arrive outside a drag and need a gesture of their own
+        if (! dragging)
+            parameter.beginChangeGesture();
+
+        parameter.setValueNotifyingHost(parameter.convertTo0to1((float) slider.getValue()));
+        lastValue = parameter.getValue();
+
+        if (! dragging)
+            parameter.endChangeGesture();
+    };
+
+    update();
 }
 
-//==============================================================================
-JulesAmpAudioProcessorEditor::JulesAmpAudioProcessorEditor (JulesAmpAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
-{   
+ThrottledSliderAttachment::~ThrottledSliderAttachment()
+{
+    if (dragging)
+        parameter.endChangeGesture();
 
-    //Adding Slider and type of Slider (Rotary)
-    addAndMakeVisible(driveKnob = new juce::Slider("Drive"));
-    driveKnob->setSliderStyle(juce::Slider::Rotary);
-    driveKnob->setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 100);
+    slider.onDragStart = nullptr;
+    slider.onDragEnd = nullptr;
+    slider.onValueChange = nullptr;
+}
 
-    addAndMakeVisible(rangeKnob = new juce::Slider("Range"));
-    rangeKnob->setSliderStyle(juce::Slider::Rotary);
-    rangeKnob->setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 100);
+void ThrottledSliderAttachment::update()
+{
+    auto value = parameter.getValue();
 
-    addAndMakeVisible(blendKnob = new juce::Slider("Blend"));
-    blendKnob->setSliderStyle(juce::Slider::Rotary);
-    blendKnob->setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 100);
+    if (value == lastValue)
+        return;
 
-    addAndMakeVisible(volumeKnob = new juce::Slider("Volume"));
-    volumeKnob->setSliderStyle(juce::Slider::Rotary);
-    volumeKnob->setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 100);
+    lastValue = value;
+    slider.setValue((double) parameter.convertFrom0to1(value), juce::dontSendNotification);
+}
 
-    driveAttachement = new juce::AudioProcessorValueTreeState::SliderAttachment(p.getState(), "drive", *driveKnob);
-    rangeAttachement = new juce::AudioProcessorValueTreeState::SliderAttachment(p.getState(), "range", *rangeKnob);
-    blendAttachement = new juce::AudioProcessorValueTreeState::SliderAttachment(p.getState(), "blend", *blendKnob);
-    volumeAttachement = new juce::AudioProcessorValueTreeState::SliderAttachment(p.getState(), "volume", *volumeKnob);
+//==============================================================================
+JulesAmpAudioProcessorEditor::JulesAmpAudioProcessorEditor (JulesAmpAudioProcessor& p)
+    : AudioProcessorEditor (&p), audioProcessor (p), meterDisplay (p.getLevelMeter())
+{   
 
-    setSize (600, 400); //Change size to match JulesEQ
+    //Adding Slider and type of Slider (Rotary)
+    addAndMakeVisible(driveKnob = new RotarySliderWithLabels(*p.getState().getParameter("drive"), ""));
+    addAndMakeVisible(rangeKnob = new RotarySliderWithLabels(*p.getState().getParameter("range"), ""));
+    addAndMakeVisible(blendKnob = new RotarySliderWithLabels(*p.getState().getParameter("blend"), ""));
+    addAndMakeVisible(volumeKnob = new RotarySliderWithLabels(*p.getState().getParameter("volume"), ""));
+
+    driveAttachement = new ThrottledSliderAttachment(*p.getState().getParameter("drive"), *driveKnob);
+    rangeAttachement = new ThrottledSliderAttachment(*p.getState().getParameter("range"), *rangeKnob);
+    blendAttachement = new ThrottledSliderAttachment(*p.getState().getParameter("blend"), *blendKnob);
+    volumeAttachement = new ThrottledSliderAttachment(*p.getState().getParameter("volume"), *volumeKnob);
+
+    impulseResponseButton.onClick = [this] { chooseImpulseResponse(); };
+    unloadImpulseResponseButton.onClick = [this]
+    {
+        audioProcessor.unloadCabinetImpulseResponse();
+        updateImpulseResponseButton();
+    };
+    updateImpulseResponseButton();
+    addAndMakeVisible (impulseResponseButton);
+    addAndMakeVisible (unloadImpulseResponseButton);
+    addAndMakeVisible (meterDisplay);
+
+   #if JULESAMP_ENABLE_PROFILER
+    cpuLabel.setJustificationType (juce::Justification::centred);
+    cpuLabel.setColour (juce::Label::textColourId, juce::Colour (185u, 108u, 255u));
+    addAndMakeVisible (cpuLabel);
+   #endif
+
+    // paint() covers every pixel, so nothing behind the editor needs repainting
+    setOpaque (true);
+
+    // Any size from half to three times the default, always in proportion
+    setResizable (true, true);
+    setResizeLimits (defaultWidth / 2, defaultHeight / 2, defaultWidth * 3, defaultHeight * 3);
+    getConstrainer()->setFixedAspectRatio ((double) defaultWidth / defaultHeight);
+
+    setSize (defaultWidth, defaultHeight); //Change size to match JulesEQ
+
+    // Automation reaches the knobs on this tick rather than per parameter change
+    startTimerHz (maxFrameRate);
 }
 
 JulesAmpAudioProcessorEditor::~JulesAmpAudioProcessorEditor()
@@ -170,36 +326,38 @@ JulesAmpAudioProcessorEditor::~JulesAmpAudioProcessorEditor()
 //==============================================================================
 void JulesAmpAudioProcessorEditor::paint (juce::Graphics& g)
 {
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-   // g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! background.isValid() || scale != backgroundScale)
+        renderBackground (scale);
+
+    g.drawImageTransformed (background, juce::AffineTransform::scale (1.0f / backgroundScale));
+}
 
-    //g.setColour (juce::Colours::white);
-    //g.setFont (15.0f);
-    //g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
+void JulesAmpAudioProcessorEditor::renderBackground (float scale)
+{
     using namespace juce;
-    auto bounds = getLocalBounds();
+
+    // At the physical resolution, so the cached text is as sharp as drawing it live
+    background = Image (Image::RGB, jmax (1, roundToInt (getWidth() * scale)), jmax (1, roundToInt (getHeight() * scale)), false);
+    backgroundScale = scale;
+
+    Graphics g (background);
+    g.addTransform (AffineTransform::scale (scale));
+
     g.fillAll(Colour(1u, 8u, 108u));//(Colours::white); //was black
     String title{ "JulesAmp" };
-    g.setFont(30);
+    g.setFont(titleFont);
     g.setColour(Colour(140u, 33u, 255u));
-    g.drawFittedText(title, bounds, juce::Justification::centred, 1);
-
+    g.drawFittedText(title, titleArea, juce::Justification::centred, 1);
 
-    g.setFont(30);
-    g.setColour(Colour(185u, 108u, 255u));
-    g.drawText("Range", ((getWidth() / 6) * 1) - (100 / 2), (getHeight() / 2) + 10, 100, 100, Justification::centred, false);
+    const char* labels[numKnobs] = { "Drive", "Range", "Blend", "Volume" };
 
-    g.setFont(30);
+    g.setFont(labelFont);
     g.setColour(Colour(185u, 108u, 255u));
-    g.drawText("Volume", ((getWidth() / 1) * 1) - (300 / 2), (getHeight() / 2) + 10, 100, 100, Justification::centred, false);
 
-    g.setFont(30);
-    g.setColour(Colour(185u, 108u, 255u));
-    g.drawText("Drive", ((getWidth() / 6) * 1) - (100 / 2), (getHeight() / 6) + -50, 100, 100, Justification::centred, false);
-
-    g.setFont(30);
-    g.setColour(Colour(185u, 108u, 255u));
-    g.drawText("Blend", ((getWidth() / 1) * 1) - (300 / 2), (getHeight() / 6) + -50, 100, 100, Justification::centred, false);
+    for (int i = 0; i < numKnobs; ++i)
+        g.drawText(labels[i], knobLabels[i], Justification::centred, false);
 }
 
 void JulesAmpAudioProcessorEditor::resized()
@@ -207,18 +365,98 @@ void JulesAmpAudioProcessorEditor::resized()
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
 
+    // Everything is laid out here once per size, in proportion to the default
+    // layout. paint() only ever blits what this computes.
+    using juce::roundToInt;
+
+    const auto scale = getWidth() / (float) defaultWidth;
+    background = {};
+
     auto bounds = getLocalBounds();
 
     auto leftArea = bounds.removeFromLeft(bounds.getWidth() * 0.33);
     auto rightArea = bounds.removeFromRight(bounds.getWidth() * 0.5);
 
-    driveKnob->setBounds(leftArea.removeFromTop(leftArea.getHeight() * 0.5));
-    rangeKnob->setBounds(leftArea);
-    blendKnob->setBounds(rightArea.removeFromTop(rightArea.getHeight() * 0.5));
-    volumeKnob->setBounds(rightArea);
+    // Each knob sits under its own label
+    const auto labelHeight = roundToInt(40 * scale);
+    const auto knobMargin = roundToInt(8 * scale);
+    juce::Component* knobs[numKnobs] = { driveKnob, rangeKnob, blendKnob, volumeKnob };
+    juce::Rectangle<int> knobAreas[numKnobs] = { leftArea.removeFromTop(leftArea.getHeight() / 2), leftArea,
+                                                 rightArea.removeFromTop(rightArea.getHeight() / 2), rightArea };
 
-    /*driveKnob->setBounds(((getWidth() / 5) * 1) - (100 / 2), (getHeight() / 2) - (100 / 2), 100, 100);
-    rangeKnob->setBounds(((getWidth() / 5) * 2) - (100 / 2), (getHeight() / 2) - (100 / 2), 100, 100);
-    blendKnob->setBounds(((getWidth() / 5) * 3) - (100 / 2), (getHeight() / 2) - (100 / 2), 100, 100);
-    volumeKnob->setBounds(((getWidth() / 5) * 4) - (100 / 2), (getHeight() / 2) - (100 / 2), 100, 100);*/
-}
\ No newline at end of file
+    for (int i = 0; i < numKnobs; ++i)
+    {
+        knobLabels[i] = knobAreas[i].removeFromTop(labelHeight);
+        knobs[i]->setBounds(knobAreas[i].reduced(knobMargin));
+    }
+
+    labelFont = juce::Font(30 * scale);
+    titleFont = juce::Font(30 * scale);
+
+   #if JULESAMP_ENABLE_PROFILER
+    cpuLabel.setFont (juce::Font (15 * scale));
+    cpuLabel.setBounds (bounds.removeFromBottom (roundToInt (30 * scale)));
+   #endif
+
+    auto impulseResponseArea = bounds.removeFromBottom (roundToInt (40 * scale)).reduced (roundToInt (10 * scale), roundToInt (6 * scale));
+    unloadImpulseResponseButton.setBounds (impulseResponseArea.removeFromRight (roundToInt (70 * scale)));
+    impulseResponseArea.removeFromRight (roundToInt (6 * scale));
+    impulseResponseButton.setBounds (impulseResponseArea);
+
+    // The meters over the title, which takes what's left of the middle column
+    meterDisplay.setBounds (bounds.removeFromTop (roundToInt (bounds.getHeight() * 0.6f)).reduced (roundToInt (6 * scale)));
+    titleArea = bounds;
+}
+
+void JulesAmpAudioProcessorEditor::chooseImpulseResponse()
+{
+    impulseResponseChooser = std::make_unique<juce::FileChooser> ("Load a cabinet impulse response",
+                                                                  audioProcessor.getCabinetImpulseResponse(),
+                                                                  "*.wav;*.aif;*.aiff;*.flac");
+
+    auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+
+    impulseResponseChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+
+        // Cancelling leaves the current IR alone, "No Cab" is how it's switched off
+        if (file == juce::File())
+            return;
+
+        audioProcessor.loadCabinetImpulseResponse (file);
+        updateImpulseResponseButton();
+    });
+}
+
+void JulesAmpAudioProcessorEditor::updateImpulseResponseButton()
+{
+    auto file = audioProcessor.getCabinetImpulseResponse();
+    impulseResponseButton.setButtonText (file == juce::File() ? "Load Cab IR..." : file.getFileNameWithoutExtension());
+    unloadImpulseResponseButton.setEnabled (file != juce::File());
+}
+
+void JulesAmpAudioProcessorEditor::timerCallback()
+{
+    for (auto* attachment : { driveAttachement.get(), rangeAttachement.get(), blendAttachement.get(), volumeAttachement.get() })
+        attachment->update();
+
+    meterDisplay.update();
+
+   #if JULESAMP_ENABLE_PROFILER
+    // The readout only needs a few updates a second
+    if (++profilerTicks < maxFrameRate / 4)
+        return;
+
+    profilerTicks = 0;
+
+    auto stats = audioProcessor.getProfiler().getStats();
+
+    juce::String text;
+    text << "CPU " << juce::roundToInt (stats.averageLoad * 100.0f) << "%"
+         << "  peak " << juce::roundToInt (stats.peakLoad * 100.0f) << "%"
+         << "  overruns " << (int) stats.numOverruns;
+
+    cpuLabel.setText (text, juce::dontSendNotification);
+   #endif
+}
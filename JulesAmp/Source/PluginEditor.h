@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "MeterDisplay.h"
 
 struct LookAndFeel : juce::LookAndFeel_V4
 {
@@ -20,6 +21,26 @@ struct LookAndFeel : juce::LookAndFeel_V4
         float rotaryEndAngle,
         juce::Slider&) override;
 
+    /** Knob with pointer and value readout. The body and the unrotated pointer
+        are cached per size, so a redraw is one image blit, one path fill and
+        the text.
+    */
+    void drawKnob(juce::Graphics&, juce::Rectangle<float> bounds, float angle,
+        const juce::String& text, float textWidth, int textHeight);
+
+private:
+    struct KnobBody
+    {
+        int width = 0, height = 0, textHeight = 0;
+        float scale = 0;
+        juce::Image image;
+        juce::Path pointer;
+    };
+
+    const KnobBody& getKnobBody(juce::Graphics&, juce::Rectangle<float> bounds, int textHeight);
+
+    // A handful of knob sizes at most, so a linear search is plenty
+    std::vector<KnobBody> knobBodies;
 };
 
 struct RotarySliderWithLabels : juce::Slider
@@ -30,6 +51,9 @@ struct RotarySliderWithLabels : juce::Slider
         param(&rap),
         suffix(unitSuffix)
     {
+        // Drag and drawing share the same sweep
+        setRotaryParameters(juce::degreesToRadians(180.f + 45.f),
+            juce::degreesToRadians(180.f - 45.f) + juce::MathConstants<float>::twoPi, true);
         setLookAndFeel(&lnf);
     }
 
@@ -39,22 +63,65 @@ struct RotarySliderWithLabels : juce::Slider
     }
 
     void paint(juce::Graphics& g) override;
-    juce::Rectangle<int> getSliderBounds() const;
-    int getTextHeight() const { return 14; }
+    void resized() override;
+    juce::Rectangle<int> getSliderBounds() const { return sliderBounds; }
+    int getTextHeight() const { return textHeight; }
     juce::String getDisplayString() const;
 private:
     LookAndFeel lnf;
 
+    // Square and centred, with the readout sized to match, set in resized()
+    juce::Rectangle<int> sliderBounds;
+    int textHeight = 14;
+
     juce::RangedAudioParameter* param;
     juce::String suffix;
+
+    // The readout is only formatted and measured when the value moves
+    double displayedValue = std::numeric_limits<double>::quiet_NaN();
+    juce::String displayText;
+    float displayTextWidth = 0;
+};
+
+//==============================================================================
+/** Connects a slider to a parameter like APVTS::SliderAttachment, except that
+    parameter changes reach the slider only when update() polls them. The
+    editor does that once per frame, so automation can't trigger more knob
+    repaints than the frame rate allows. Slider moves still go straight to the
+    parameter.
+*/
+class ThrottledSliderAttachment
+{
+public:
+    ThrottledSliderAttachment(juce::RangedAudioParameter&, juce::Slider&);
+    ~ThrottledSliderAttachment();
+
+    /** Message thread. Moves the slider if the parameter changed since the last call. */
+    void update();
+
+private:
+    juce::RangedAudioParameter& parameter;
+    juce::Slider& slider;
+    float lastValue = -1.0f;   // normalised, -1 forces the first update
+    bool dragging = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ThrottledSliderAttachment)
 };
 
 //==============================================================================
 /**
 */
-class JulesAmpAudioProcessorEditor  : public juce::AudioProcessorEditor
+class JulesAmpAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                      private juce::Timer
 {
 public:
+    /** Parameter changes are picked up at most this often. */
+    static constexpr int maxFrameRate = 30;
+
+    /** The layout is designed at this size and scales with the window. */
+    static constexpr int defaultWidth = 600;
+    static constexpr int defaultHeight = 400;
+
     JulesAmpAudioProcessorEditor (JulesAmpAudioProcessor&);
     ~JulesAmpAudioProcessorEditor() override;
 
@@ -64,15 +131,15 @@ public:
 
 private:
 
-    juce::ScopedPointer<juce::Slider> driveKnob;
-    juce::ScopedPointer<juce::Slider> rangeKnob;
-    juce::ScopedPointer<juce::Slider> blendKnob;
-    juce::ScopedPointer<juce::Slider> volumeKnob;
+    juce::ScopedPointer<RotarySliderWithLabels> driveKnob;
+    juce::ScopedPointer<RotarySliderWithLabels> rangeKnob;
+    juce::ScopedPointer<RotarySliderWithLabels> blendKnob;
+    juce::ScopedPointer<RotarySliderWithLabels> volumeKnob;
 
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> driveAttachement;
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> rangeAttachement;
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> blendAttachement;
-    juce::ScopedPointer<juce::AudioProcessorValueTreeState::SliderAttachment> volumeAttachement;
+    juce::ScopedPointer<ThrottledSliderAttachment> driveAttachement;
+    juce::ScopedPointer<ThrottledSliderAttachment> rangeAttachement;
+    juce::ScopedPointer<ThrottledSliderAttachment> blendAttachement;
+    juce::ScopedPointer<ThrottledSliderAttachment> volumeAttachement;
 
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
@@ -80,5 +147,30 @@ private:
     std::vector<juce::Component*> getComps();
     LookAndFeel lnf;
 
+    void chooseImpulseResponse();
+    void updateImpulseResponseButton();
+    void renderBackground(float scale);
+    void timerCallback() override;
+
+    // Title and labels, drawn once per size and display scale
+    juce::Image background;
+    float backgroundScale = 0;
+
+    // Geometry for the background, laid out in resized()
+    static constexpr int numKnobs = 4;
+    juce::Rectangle<int> titleArea;
+    juce::Rectangle<int> knobLabels[numKnobs];
+    juce::Font titleFont, labelFont;
+
+    juce::TextButton impulseResponseButton;
+    juce::TextButton unloadImpulseResponseButton { "No Cab" };
+    MeterDisplay meterDisplay;
+    std::unique_ptr<juce::FileChooser> impulseResponseChooser;
+
+   #if JULESAMP_ENABLE_PROFILER
+    juce::Label cpuLabel;
+    int profilerTicks = 0;
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JulesAmpAudioProcessorEditor)
 };
@@ -16,6 +16,7 @@ JulesAmpAudioProcessor::JulesAmpAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
@@ -25,18 +26,93 @@ JulesAmpAudioProcessor::JulesAmpAudioProcessor()
     state = new juce::AudioProcessorValueTreeState(*this, nullptr);
 
     state->createAndAddParameter("drive", "Drive", "Drive", juce::NormalisableRange<float>(0.f, 1.f, 0.0001), 1.0, nullptr, nullptr);
-    state->createAndAddParameter("range", "Range", "Range", juce::NormalisableRange<float>(0.f, 1500.f, 0.0001, 0.25f), 1.0, nullptr, nullptr);
+    // Range steps by 0.001: near 1500 a float can't hold anything finer, and
+    // a finer step wouldn't survive a save and restore unchanged
+    state->createAndAddParameter("range", "Range", "Range", juce::NormalisableRange<float>(0.f, 1500.f, 0.001, 0.25f), 1.0, nullptr, nullptr);
     state->createAndAddParameter("blend", "Blend", "Blend", juce::NormalisableRange<float>(0.f, 1.f, 0.0001), 1.0, nullptr, nullptr);
     state->createAndAddParameter("volume", "Volume", "Volume", juce::NormalisableRange<float>(0.f, 3.f, 0.0001), 1.0, nullptr, nullptr);
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("quality", "Quality", juce::StringArray { "Off", "2x", "4x", "8x" }, 0));
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("filter", "Filter", juce::StringArray { "IIR (Low Latency)", "FIR (Linear Phase)" }, 0));
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("table", "Table", juce::StringArray { "Off", "Low", "Medium", "High" }, 0));
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("bands", "Bands", juce::StringArray { "Off", "2 Bands", "3 Bands", "4 Bands" }, 0));
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("curve", "Curve", juce::StringArray { "Atan", "Tanh", "Hard Clip", "Diode", "Foldback", "Cubic" }, 0));
+    state->createAndAddParameter("lowcut", "Low Cut", "Hz", juce::NormalisableRange<float>(20.f, 1000.f, 1.f, 0.3f), 20.f, nullptr, nullptr);
+    state->createAndAddParameter("emphasis", "Emphasis", "dB", juce::NormalisableRange<float>(0.f, 18.f, 0.1f), 0.f, nullptr, nullptr);
+    state->createAndAddParameter("bass", "Bass", "dB", juce::NormalisableRange<float>(-12.f, 12.f, 0.1f), 0.f, nullptr, nullptr);
+    state->createAndAddParameter("mid", "Mid", "dB", juce::NormalisableRange<float>(-12.f, 12.f, 0.1f), 0.f, nullptr, nullptr);
+    state->createAndAddParameter("treble", "Treble", "dB", juce::NormalisableRange<float>(-12.f, 12.f, 0.1f), 0.f, nullptr, nullptr);
+    state->createAndAddParameter("cabinet", "Cabinet", "Hz", juce::NormalisableRange<float>(1000.f, 20000.f, 1.f, 0.3f), 20000.f, nullptr, nullptr);
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterBool>("ir", "Cabinet IR", true));
+    state->createAndAddParameter("dynamics", "Dynamics", "Depth", juce::NormalisableRange<float>(-1.f, 1.f, 0.001f), 0.f, nullptr, nullptr);
+    state->createAndAddParameter("attack", "Attack", "ms", juce::NormalisableRange<float>(0.1f, 100.f, 0.01f, 0.4f), 5.f, nullptr, nullptr);
+    state->createAndAddParameter("release", "Release", "ms", juce::NormalisableRange<float>(5.f, 1000.f, 0.1f, 0.4f), 120.f, nullptr, nullptr);
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("detector", "Detector", juce::StringArray { "Peak", "RMS" }, 0));
+    state->createAndAddParameter(std::make_unique<juce::AudioParameterChoice>("key", "Key", juce::StringArray { "Input", "Sidechain" }, 0));
+    state->createAndAddParameter("duck", "Duck", "Depth", juce::NormalisableRange<float>(0.f, 1.f, 0.001f), 0.f, nullptr, nullptr);
+
+    const float defaultCrossovers[] = { 200.f, 1000.f, 5000.f };
+
+    for (int i = 0; i < numCrossovers; ++i)
+    {
+        juce::String index (i + 1);
+        state->createAndAddParameter("crossover" + index, "Crossover " + index, "Hz", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), defaultCrossovers[i], nullptr, nullptr);
+        crossoverParams[i] = state->getRawParameterValue("crossover" + index);
+    }
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        juce::String index (band + 1);
+        state->createAndAddParameter("drive" + index, "Drive " + index, "Drive", juce::NormalisableRange<float>(0.f, 1.f, 0.0001), 1.0, nullptr, nullptr);
+        state->createAndAddParameter("range" + index, "Range " + index, "Range", juce::NormalisableRange<float>(0.f, 1500.f, 0.001, 0.25f), 1.0, nullptr, nullptr);
+        state->createAndAddParameter("blend" + index, "Blend " + index, "Blend", juce::NormalisableRange<float>(0.f, 1.f, 0.0001), 1.0, nullptr, nullptr);
+
+        bandParams[band][MultibandShaper<float>::bandDrive] = state->getRawParameterValue("drive" + index);
+        bandParams[band][MultibandShaper<float>::bandRange] = state->getRawParameterValue("range" + index);
+        bandParams[band][MultibandShaper<float>::bandBlend] = state->getRawParameterValue("blend" + index);
+    }
+
+    // Resolved once, so the audio thread never does a parameter lookup by ID
+    automatedParams[driveParameter] = state->getRawParameterValue("drive");
+    automatedParams[rangeParameter] = state->getRawParameterValue("range");
+    automatedParams[blendParameter] = state->getRawParameterValue("blend");
+    automatedParams[volumeParameter] = state->getRawParameterValue("volume");
+    qualityParam = state->getRawParameterValue("quality");
+    filterParam = state->getRawParameterValue("filter");
+    tableParam = state->getRawParameterValue("table");
+    bandsParam = state->getRawParameterValue("bands");
+    curveParam = state->getRawParameterValue("curve");
+    lowCutParam = state->getRawParameterValue("lowcut");
+    emphasisParam = state->getRawParameterValue("emphasis");
+    bassParam = state->getRawParameterValue("bass");
+    midParam = state->getRawParameterValue("mid");
+    trebleParam = state->getRawParameterValue("treble");
+    cabinetParam = state->getRawParameterValue("cabinet");
+    impulseResponseParam = state->getRawParameterValue("ir");
+    dynamicsParam = state->getRawParameterValue("dynamics");
+    attackParam = state->getRawParameterValue("attack");
+    releaseParam = state->getRawParameterValue("release");
+    detectorParam = state->getRawParameterValue("detector");
+    keyParam = state->getRawParameterValue("key");
+    duckParam = state->getRawParameterValue("duck");
+
+    float defaults[StateFormat::numParameters] = {};
+
+    for (int i = 0; i < StateFormat::numParameters; ++i)
+    {
+        stateParameters[i] = state->getParameter (StateFormat::parameterIDs[i]);
+
+        if (auto* param = stateParameters[i])
+            defaults[i] = param->convertFrom0to1 (param->getDefaultValue());
+    }
+
+    presets.addFactoryPresets (defaults);
 
-    state->state = juce::ValueTree("drive");
-    state->state = juce::ValueTree("range");
-    state->state = juce::ValueTree("blend");
-    state->state = juce::ValueTree("volume");
+    state->state = juce::ValueTree ("JulesAmp");
 }
 
 JulesAmpAudioProcessor::~JulesAmpAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -74,31 +150,48 @@ bool JulesAmpAudioProcessor::isMidiEffect() const
 
 double JulesAmpAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    auto sampleRate = getSampleRate();
+    return sampleRate > 0 ? tailLengthSamples.load (std::memory_order_relaxed) / sampleRate : 0.0;
 }
 
 int JulesAmpAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return presets.size();
 }
 
 int JulesAmpAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load (std::memory_order_relaxed);
 }
 
 void JulesAmpAudioProcessor::setCurrentProgram (int index)
 {
+    auto* preset = presets.getPreset (index);
+
+    if (preset == nullptr)
+        return;
+
+    // The host and editor follow the parameters, and the audio thread picks
+    // them up like any other change: the smoothers glide from the old values
+    // to the new ones and a new curve crossfades in, without a click.
+    for (int i = 0; i < StateFormat::numParameters; ++i)
+        if (auto* param = stateParameters[i])
+            param->setValueNotifyingHost (param->convertTo0to1 (preset->values[i]));
+
+    currentProgram.store (index, std::memory_order_relaxed);
 }
 
 const juce::String JulesAmpAudioProcessor::getProgramName (int index)
 {
+    if (auto* preset = presets.getPreset (index))
+        return juce::String::fromUTF8 (preset->name);
+
     return {};
 }
 
 void JulesAmpAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    presets.rename (index, newName);
 }
 
 //==============================================================================
@@ -106,6 +199,117 @@ void JulesAmpAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 {
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
+    auto settings = readEngineSettings();
+    std::fill (std::begin (settings.retarget), std::end (settings.retarget), true);
+
+    const auto numChannels = juce::jmax (getMainBusNumInputChannels(), getMainBusNumOutputChannels());
+
+    // Offline renders get a thread pool and one engine per channel group on
+    // top of the main one. Real-time processing never touches either.
+    offlinePool.reset();
+    floatLanes.engines.clear();
+    doubleLanes.engines.clear();
+
+    const auto numThreads = juce::jmin (numChannels, maxOfflineThreads > 0 ? maxOfflineThreads
+                                                                           : juce::SystemStats::getNumCpus());
+
+    if (isNonRealtime() && numThreads > 1)
+        offlinePool = std::make_unique<WorkStealingPool> (numThreads);
+
+    // Only the engine for the precision the host asked for gets its buffers
+    if (isUsingDoublePrecision())
+    {
+        prepareEngine (doubleEngine, sampleRate, samplesPerBlock, numChannels, settings);
+        prepareLanes (doubleLanes, sampleRate, samplesPerBlock, numChannels, settings);
+        updateLatency (doubleEngine);
+    }
+    else
+    {
+        prepareEngine (floatEngine, sampleRate, samplesPerBlock, numChannels, settings);
+        prepareLanes (floatLanes, sampleRate, samplesPerBlock, numChannels, settings);
+        updateLatency (floatEngine);
+    }
+
+    cabinetConvolver.prepare (sampleRate, samplesPerBlock, numChannels);
+    impulseResponseWasEnabled = false;
+    levelMeter.prepare (samplesPerBlock);
+
+    renderPosition = 0;
+    parameterEvents.clear();
+    numProcessedBlocks.store (0, std::memory_order_relaxed);
+    numSkippedBlocks.store (0, std::memory_order_relaxed);
+
+   #if JULESAMP_ENABLE_PROFILER
+    profiler.prepare (sampleRate);
+   #endif
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::prepareEngine (DistortionEngine<SampleType>& engine, double sampleRate, int samplesPerBlock,
+                                            int numChannels, const EngineSettings& settings)
+{
+    // Configured before the first callback and snapped there, so a fresh lane
+    // starts out in exactly the state the main engine does
+    engine.prepare (sampleRate, samplesPerBlock, numChannels);
+    applyEngineSettings (engine, settings);
+    engine.snapToTargets();
+}
+
+namespace
+{
+    /** The channels a lane renders: contiguous groups, as even as they go. */
+    juce::Range<int> getLaneChannels (int lane, int numLanes, int numChannels) noexcept
+    {
+        return { lane * numChannels / numLanes, (lane + 1) * numChannels / numLanes };
+    }
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::prepareLanes (OfflineLanes<SampleType>& lanes, double sampleRate, int samplesPerBlock,
+                                           int numChannels, const EngineSettings& settings)
+{
+    lanes.numChannels = numChannels;
+
+    if (offlinePool == nullptr)
+    {
+        lanes.input.setSize (0, 0);
+        return;
+    }
+
+    const auto numLanes = offlinePool->getNumThreads();
+
+    for (int lane = 0; lane < numLanes; ++lane)
+        prepareEngine (*lanes.engines.add (new DistortionEngine<SampleType> (shaperTable)), sampleRate, samplesPerBlock,
+                       getLaneChannels (lane, numLanes, numChannels).getLength(), settings);
+
+    // A chunk takes every sub-block starting within one prepared block, so it
+    // can run to twice that. Every sub-block but the last ends at an event.
+    lanes.input.setSize (numChannels, 2 * samplesPerBlock);
+    lanes.maxEvents = parameterEvents.getCapacity();
+    lanes.events.allocate ((size_t) lanes.maxEvents, false);
+    lanes.subBlocks.allocate ((size_t) lanes.maxEvents + 2, false);
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::updateLatency (const DistortionEngine<SampleType>& engine)
+{
+    tailLengthSamples.store (engine.getTailLengthSamples(), std::memory_order_relaxed);
+    pendingLatencySamples.store (engine.getLatencySamples(), std::memory_order_relaxed);
+    cancelPendingUpdate();
+    setLatencySamples (engine.getLatencySamples());
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::publishLatency (const DistortionEngine<SampleType>& engine) noexcept
+{
+    tailLengthSamples.store (engine.getTailLengthSamples(), std::memory_order_relaxed);
+    pendingLatencySamples.store (engine.getLatencySamples(), std::memory_order_relaxed);
+    triggerAsyncUpdate();
+}
+
+void JulesAmpAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples (pendingLatencySamples.load (std::memory_order_relaxed));
 }
 
 void JulesAmpAudioProcessor::releaseResources()
@@ -114,6 +318,103 @@ void JulesAmpAudioProcessor::releaseResources()
     // spare memory, etc.
 }
 
+bool JulesAmpAudioProcessor::scheduleParameterChange (AutomatedParameter parameter, float value, juce::int64 samplePosition)
+{
+    return parameterEvents.push ({ samplePosition, (int) parameter, value });
+}
+
+JulesAmpAudioProcessor::EngineSettings JulesAmpAudioProcessor::readEngineSettings() noexcept
+{
+    EngineSettings settings;
+    settings.offline = isNonRealtime();
+    settings.quality = (int) qualityParam->load();
+    settings.filter = (int) filterParam->load();
+
+    // Host and GUI changes only retarget a smoother when the parameter actually
+    // moved, so they don't undo a sample-accurate event from an earlier block.
+    for (int i = 0; i < numAutomatedParameters; ++i)
+    {
+        settings.targets[i] = automatedParams[i]->load();
+        settings.retarget[i] = settings.targets[i] != lastHostValues[i];
+        lastHostValues[i] = settings.targets[i];
+    }
+
+    // Offline renders shape directly: whether a table is ready yet depends on
+    // the builder thread's timing, and a bounce should come out the same every time.
+    settings.table = settings.offline ? (int) ShaperTable::off : (int) tableParam->load();
+    settings.curve = (int) curveParam->load();
+
+    settings.lowCut = lowCutParam->load();
+    settings.emphasis = emphasisParam->load();
+    settings.bass = bassParam->load();
+    settings.mid = midParam->load();
+    settings.treble = trebleParam->load();
+    settings.cabinet = cabinetParam->load();
+
+    settings.depth = dynamicsParam->load();
+    settings.duck = duckParam->load();
+    settings.attack = attackParam->load();
+    settings.release = releaseParam->load();
+    settings.rms = detectorParam->load() >= 0.5f;
+
+    settings.bands = (int) bandsParam->load() + 1;
+
+    for (int i = 0; i < numCrossovers; ++i)
+        settings.crossovers[i] = crossoverParams[i]->load();
+
+    for (int band = 0; band < numBands; ++band)
+        for (int parameter = 0; parameter < MultibandShaper<float>::numBandParameters; ++parameter)
+            settings.bandValues[band][parameter] = bandParams[band][parameter]->load();
+
+    return settings;
+}
+
+template <typename SampleType>
+bool JulesAmpAudioProcessor::applyEngineSettings (DistortionEngine<SampleType>& engine, const EngineSettings& settings) noexcept
+{
+    auto oversamplingChanged = engine.setOversampling (settings.quality, settings.filter);
+
+    for (int i = 0; i < numAutomatedParameters; ++i)
+        if (settings.retarget[i])
+            engine.setTarget (i, settings.targets[i]);
+
+    engine.setTableResolution (settings.table);
+    engine.setCurve (settings.curve);
+
+    typename AmpVoicing<SampleType>::Settings voicing;
+    voicing.lowCut = settings.lowCut;
+    voicing.emphasis = settings.emphasis;
+    voicing.bass = settings.bass;
+    voicing.mid = settings.mid;
+    voicing.treble = settings.treble;
+    voicing.cabinet = settings.cabinet;
+    engine.setVoicing (voicing);
+    engine.setDynamics (settings.depth, settings.duck, settings.attack, settings.release, settings.rms);
+    engine.setNumBands (settings.bands);
+
+    for (int i = 0; i < numCrossovers; ++i)
+        engine.setCrossover (i, settings.crossovers[i]);
+
+    for (int band = 0; band < numBands; ++band)
+        for (int parameter = 0; parameter < MultibandShaper<SampleType>::numBandParameters; ++parameter)
+            engine.setBandTarget (band, parameter, settings.bandValues[band][parameter]);
+
+    return oversamplingChanged;
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::applyDueParameterEvents (DistortionEngine<SampleType>& engine, juce::int64 position) noexcept
+{
+    while (auto* event = parameterEvents.peek())
+    {
+        if (event->position > position)
+            break;
+
+        engine.setCurrentAndTarget (event->parameter, event->value);
+        parameterEvents.pop();
+    }
+}
+
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool JulesAmpAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
@@ -121,18 +422,29 @@ bool JulesAmpAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any matched layout works, from mono up to surround and ambisonic buses:
+    // the shaper treats every channel the same way.
+    auto numChannels = layouts.getMainOutputChannelSet().size();
+
+    if (layouts.getMainOutputChannelSet().isDisabled()
+     || numChannels > DistortionEngine<float>::maxNumChannels)
         return false;
 
     // This checks if the input layout matches the output layout
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain only feeds the detector, which sums its channels anyway
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet (true, 1);
+
+        if (! sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -142,8 +454,24 @@ bool JulesAmpAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 
 void JulesAmpAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    processSamples (buffer, floatEngine, floatLanes);
+}
+
+void JulesAmpAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples (buffer, doubleEngine, doubleLanes);
+}
+
+template <typename SampleType>
+void JulesAmpAudioProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer, DistortionEngine<SampleType>& engine,
+                                             OfflineLanes<SampleType>& lanes)
+{
+   #if JULESAMP_ENABLE_PROFILER
+    const CallbackProfiler::ScopedCallback profile (profiler, buffer.getNumSamples());
+   #endif
+
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     // In case we have more outputs than inputs, this code clears any output
@@ -155,31 +483,191 @@ void JulesAmpAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
+    auto settings = readEngineSettings();
+
+    if (applyEngineSettings (engine, settings))
+        publishLatency (engine);
+
+    for (auto* lane : lanes.engines)
+        applyEngineSettings (*lane, settings);
 
-    float drive = *state->getRawParameterValue("drive");
-    float range = *state->getRawParameterValue("range");
-    float blend = *state->getRawParameterValue("blend");
-    float volume = *state->getRawParameterValue("volume");
+    // Crossover moves and new IRs change the tail too, not just the oversampling stage
+    tailLengthSamples.store (engine.getTailLengthSamples() + cabinetConvolver.getTailLengthSamples(), std::memory_order_relaxed);
 
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    juce::dsp::AudioBlock<SampleType> hostBlock (buffer);
+    auto block = hostBlock.getSubsetChannelBlock (0, (size_t) totalNumInputChannels);
+
+    // The detector reads the host's sidechain channels in place, from the
+    // same buffer as the main bus. Without a sidechain it keys from the input.
+    auto key = block;
+    auto numKeyChannels = getChannelCountOfBus (true, 1);
+    const auto keyIsInput = keyParam->load() < 0.5f || numKeyChannels == 0;
+
+    if (! keyIsInput)
+        key = hostBlock.getSubsetChannelBlock ((size_t) getChannelIndexInProcessBlockBuffer (true, 1, 0), (size_t) numKeyChannels);
+
+    // Render in sub-blocks that end at the next scheduled parameter event, or
+    // at the prepared block size since the oversamplers are only sized for that
+    // much. Sub-blocks are views into the host buffer, nothing is copied.
+    const auto numSamples = block.getNumSamples();
+    const auto maxBlockSize = (size_t) engine.getMaximumBlockSize();
+    size_t start = 0;
+    bool skipped = true;
+
+    // The host didn't prepare us for this precision
+    if (maxBlockSize == 0)
     {
-        auto* channelData = buffer.getWritePointer (channel);
+        jassertfalse;
+        return;
+    }
 
-        for (int sample = 0; sample < buffer.getNumSamples(); sample++) {
+    levelMeter.measureInput (block);
 
-            float cleanSig = *channelData;
+    if (isNonRealtime() && ! lanes.engines.isEmpty() && (int) block.getNumChannels() == lanes.numChannels)
+    {
+        skipped = processLanes (block, key, keyIsInput, lanes);
+    }
+    else
+    {
+        while (start < numSamples)
+        {
+            applyDueParameterEvents (engine, renderPosition + (juce::int64) start);
+
+            auto end = juce::jmin (numSamples, start + maxBlockSize);
+
+            if (auto* next = parameterEvents.peek())
+                if (next->position < renderPosition + (juce::int64) end)
+                    end = (size_t) (next->position - renderPosition);
 
-            *channelData *= drive * range;
-            *channelData = (((((2.f / juce::float_Pi) * atan(*channelData)) * blend) + (cleanSig * (1.f - blend))) / 2) * volume;
-            channelData++;
+            skipped = engine.process (block.getSubBlock (start, end - start), key.getSubBlock (start, end - start)) && skipped;
+            start = end;
         }
     }
+
+    // The cabinet runs once over the whole callback, its partitions are
+    // sized for the host block rather than our sub-blocks.
+    const auto impulseResponseEnabled = impulseResponseParam->load() >= 0.5f;
+
+    if (impulseResponseEnabled && ! impulseResponseWasEnabled)
+        cabinetConvolver.reset();
+
+    impulseResponseWasEnabled = impulseResponseEnabled;
+
+    if (impulseResponseEnabled)
+        skipped = cabinetConvolver.process (block) && skipped;
+
+    levelMeter.measureOutput (block);
+
+    renderPosition += (juce::int64) numSamples;
+
+    numProcessedBlocks.store (numProcessedBlocks.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (skipped && numSamples > 0)
+        numSkippedBlocks.store (numSkippedBlocks.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+bool JulesAmpAudioProcessor::processLanes (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<SampleType> key,
+                                           bool keyIsInput, OfflineLanes<SampleType>& lanes) noexcept
+{
+    const auto numSamples = block.getNumSamples();
+    const auto maxBlockSize = (size_t) lanes.engines.getFirst()->getMaximumBlockSize();
+    const auto numLanes = lanes.engines.size();
+    juce::dsp::AudioBlock<SampleType> inputCopy (lanes.input);
+    bool skipped = true;
+
+    for (size_t chunkStart = 0; chunkStart < numSamples;)
+    {
+        // Split exactly where the serial loop would, taking the events due at
+        // each split, so every lane replays the same sub-blocks and changes.
+        // Starting within one prepared block keeps the chunk inside the copy.
+        int numSubBlocks = 0, numEvents = 0;
+        auto start = chunkStart;
+
+        while (start < numSamples && start < chunkStart + maxBlockSize)
+        {
+            auto& subBlock = lanes.subBlocks[numSubBlocks++];
+            subBlock.firstEvent = numEvents;
+
+            while (numEvents < lanes.maxEvents)
+            {
+                auto* event = parameterEvents.peek();
+
+                if (event == nullptr || event->position > renderPosition + (juce::int64) start)
+                    break;
+
+                lanes.events[numEvents++] = *event;
+                parameterEvents.pop();
+            }
+
+            auto end = juce::jmin (numSamples, start + maxBlockSize);
+
+            if (auto* next = parameterEvents.peek())
+                if (next->position < renderPosition + (juce::int64) end)
+                    end = (size_t) juce::jmax ((juce::int64) start + 1, next->position - renderPosition);
+
+            // An event can only be due already when the cap above was hit,
+            // and then it waits for the next sub-block
+            subBlock.numEvents = numEvents - subBlock.firstEvent;
+            subBlock.start = (int) (start - chunkStart);
+            subBlock.end = (int) (end - chunkStart);
+            start = end;
+        }
+
+        const auto chunkLength = start - chunkStart;
+        auto chunk = block.getSubBlock (chunkStart, chunkLength);
+        auto input = inputCopy.getSubsetChannelBlock (0, block.getNumChannels()).getSubBlock (0, chunkLength);
+        input.copyFrom (chunk);
+
+        auto chunkKey = keyIsInput ? input : key.getSubBlock (chunkStart, chunkLength);
+
+        auto renderLane = [&] (int lane)
+        {
+            // The workers flush denormals like the host's thread does, or
+            // their groups would round differently
+            juce::ScopedNoDenormals noDenormals;
+
+            auto& engine = *lanes.engines.getUnchecked (lane);
+            const auto channels = getLaneChannels (lane, numLanes, lanes.numChannels);
+            auto group = chunk.getSubsetChannelBlock ((size_t) channels.getStart(), (size_t) channels.getLength());
+            bool laneSkipped = true;
+
+            for (int i = 0; i < numSubBlocks; ++i)
+            {
+                const auto& subBlock = lanes.subBlocks[i];
+
+                for (int e = subBlock.firstEvent; e < subBlock.firstEvent + subBlock.numEvents; ++e)
+                    engine.setCurrentAndTarget (lanes.events[e].parameter, lanes.events[e].value);
+
+                const auto subStart = (size_t) subBlock.start;
+                const auto length = (size_t) (subBlock.end - subBlock.start);
+
+                laneSkipped = engine.process (group.getSubBlock (subStart, length), chunkKey.getSubBlock (subStart, length),
+                                              input.getSubBlock (subStart, length)) && laneSkipped;
+            }
+
+            lanes.skipped[lane] = laneSkipped;
+        };
+
+        offlinePool->run (numLanes, renderLane);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            skipped = lanes.skipped[lane] && skipped;
+
+        chunkStart = start;
+    }
+
+    return skipped;
+}
+
+bool JulesAmpAudioProcessor::loadCabinetImpulseResponse (const juce::File& file)
+{
+    return cabinetConvolver.load (file);
+}
+
+void JulesAmpAudioProcessor::unloadCabinetImpulseResponse()
+{
+    cabinetConvolver.unload();
 }
 
 juce::AudioProcessorValueTreeState& JulesAmpAudioProcessor::getState() {
@@ -201,27 +689,78 @@ juce::AudioProcessorEditor* JulesAmpAudioProcessor::createEditor()
 //==============================================================================
 void JulesAmpAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    StateFormat::State saved;
+    saved.program = currentProgram.load (std::memory_order_relaxed);
+    saved.impulseResponse = cabinetConvolver.getFile().getFullPathName();
 
-    juce::MemoryOutputStream stream(destData, false);
-    state->state.writeToStream(stream);
+    for (int i = 0; i < StateFormat::numParameters; ++i)
+        saved.values[i] = stateParameters[i]->getValue();
 
+    StateFormat::write (saved, destData);
 }
 
-void JulesAmpAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+void JulesAmpAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    StateFormat::State restored;
+
+    if (! StateFormat::read (data, sizeInBytes, restored) && ! readLegacyState (data, sizeInBytes, restored))
+        return;
+
+    if (presets.getPreset (restored.program) != nullptr)
+        currentProgram.store (restored.program, std::memory_order_relaxed);
 
-    juce::ValueTree tree = juce::ValueTree::readFromData(data, sizeInBytes);
+    // A missing IR file leaves the cabinet off rather than failing the restore
+    if (restored.impulseResponse.isEmpty() || ! loadCabinetImpulseResponse (juce::File (restored.impulseResponse)))
+        unloadCabinetImpulseResponse();
+
+    // Parameters the blob didn't know about go back to their defaults
+    for (int i = 0; i < StateFormat::numParameters; ++i)
+    {
+        auto* param = stateParameters[i];
 
-    if (tree.isValid()) {
-        state->state = tree;
+        if (i >= restored.numValues)
+            param->setValueNotifyingHost (param->getDefaultValue());
+        else
+            param->setValueNotifyingHost (restored.normalised ? restored.values[i]
+                                                              : param->convertTo0to1 (restored.values[i]));
     }
 }
 
+bool JulesAmpAudioProcessor::readLegacyState (const void* data, int sizeInBytes, StateFormat::State& restored)
+{
+    // Older versions saved the whole ValueTree, whose root was named after
+    // whichever tree the constructor assigned last. Only the PARAM children
+    // matter, so match them by ID and ignore the rest.
+    // A blob starting with our magic is a damaged current one, not a tree.
+    if (data == nullptr || sizeInBytes < 4 || juce::ByteOrder::littleEndianInt (data) == StateFormat::magic)
+        return false;
+
+    auto tree = juce::ValueTree::readFromData (data, (size_t) sizeInBytes);
+
+    if (! tree.isValid())
+        return false;
+
+    restored.numValues = StateFormat::numParameters;
+    restored.normalised = false;
+    int numFound = 0;
+
+    for (int i = 0; i < StateFormat::numParameters; ++i)
+    {
+        auto child = tree.getChildWithProperty ("id", StateFormat::parameterIDs[i]);
+        auto* param = stateParameters[i];
+
+        if (child.hasProperty ("value"))
+            ++numFound;
+
+        restored.values[i] = child.hasProperty ("value") ? (float) child["value"]
+                                                         : param->convertFrom0to1 (param->getDefaultValue());
+    }
+
+    // Almost any bytes parse as some tree; one without a single parameter of
+    // ours isn't a state, and shouldn't reset everything to defaults
+    return numFound > 0;
+}
+
 //==============================================================================
 // This creates new instances of the plugin..
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -9,11 +9,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DistortionEngine.h"
+#include "ParameterEventQueue.h"
+#include "CallbackProfiler.h"
+#include "PresetBank.h"
+#include "StateFormat.h"
+#include "CabinetConvolver.h"
+#include "LevelMeter.h"
+#include "WorkStealingPool.h"
 
 //==============================================================================
 /**
 */
-class JulesAmpAudioProcessor  : public juce::AudioProcessor
+class JulesAmpAudioProcessor  : public juce::AudioProcessor,
+                                private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -29,6 +38,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override    { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -55,10 +66,199 @@ public:
 
     juce::AudioProcessorValueTreeState& getState();
 
+    //==============================================================================
+    /** Schedules a parameter change at an exact sample position, counted at
+        the host rate from the last prepareToPlay. Call from a single thread,
+        in timestamp order; events already in the past land at the start of
+        the next block. Returns false if the event queue is full.
+
+        The change is an exact step on that sample, with no smoothing: a
+        stepped automation lane comes out stepped. Host and GUI changes
+        still glide over the smoothing time.
+
+        JUCE doesn't hand us the VST3 parameter queues, so this is how offline
+        renders get automation that doesn't snap to block boundaries.
+    */
+    bool scheduleParameterChange (AutomatedParameter, float value, juce::int64 samplePosition);
+
+    /** Loads a cabinet impulse response in the background; the previous one
+        keeps playing until it's ready. Message thread only. Returns false if
+        the file isn't readable audio.
+    */
+    bool loadCabinetImpulseResponse (const juce::File&);
+    void unloadCabinetImpulseResponse();
+    juce::File getCabinetImpulseResponse() const        { return cabinetConvolver.getFile(); }
+
+    /** Callbacks since prepareToPlay, and how many of those were silent
+        and skipped the DSP entirely. Readable from any thread.
+    */
+    juce::uint32 getNumProcessedBlocks() const noexcept    { return numProcessedBlocks.load (std::memory_order_relaxed); }
+    juce::uint32 getNumSkippedBlocks() const noexcept      { return numSkippedBlocks.load (std::memory_order_relaxed); }
+
+    /** Input/output frames for the editor's meters and scope, drained from
+        the message thread.
+    */
+    LevelMeter& getLevelMeter() noexcept            { return levelMeter; }
+
+    /** Offline renders (isNonRealtime() when prepareToPlay is called) split
+        the bus into channel groups and render them on a small thread pool,
+        bit-identical to rendering on one thread. This caps the threads, the
+        host's own included: 0 uses every core, 1 keeps offline renders on
+        the host's thread. Takes effect at the next prepareToPlay.
+    */
+    void setMaximumOfflineThreads (int numThreads) noexcept     { maxOfflineThreads = juce::jmax (0, numThreads); }
+
+    /** Threads the last prepareToPlay set up for, 1 in real time. */
+    int getNumOfflineThreads() const noexcept       { return offlinePool != nullptr ? offlinePool->getNumThreads() : 1; }
+
+   #if JULESAMP_ENABLE_PROFILER
+    /** Per-callback CPU load and deadline misses, readable from any thread. */
+    CallbackProfiler& getProfiler() noexcept        { return profiler; }
+   #endif
+
 private:
 
     juce::ScopedPointer<juce::AudioProcessorValueTreeState> state;
 
+    /** Reports the engine's latency to the host right away. Not from the
+        audio thread, setLatencySamples notifies the host's listeners.
+    */
+    template <typename SampleType>
+    void updateLatency (const DistortionEngine<SampleType>&);
+
+    /** Audio thread: keeps the new latency and reports it from the message
+        thread, in handleAsyncUpdate.
+    */
+    template <typename SampleType>
+    void publishLatency (const DistortionEngine<SampleType>&) noexcept;
+
+    void handleAsyncUpdate() override;
+
+    bool readLegacyState (const void* data, int sizeInBytes, StateFormat::State&);
+
+    template <typename SampleType>
+    void applyDueParameterEvents (DistortionEngine<SampleType>&, juce::int64 position) noexcept;
+
+    std::atomic<float>* automatedParams[numAutomatedParameters] = {};
+    float lastHostValues[numAutomatedParameters] = {};
+    std::atomic<float>* qualityParam = nullptr;
+    std::atomic<float>* filterParam = nullptr;
+    std::atomic<float>* tableParam = nullptr;
+    std::atomic<float>* curveParam = nullptr;
+    std::atomic<float>* lowCutParam = nullptr;
+    std::atomic<float>* emphasisParam = nullptr;
+    std::atomic<float>* bassParam = nullptr;
+    std::atomic<float>* midParam = nullptr;
+    std::atomic<float>* trebleParam = nullptr;
+    std::atomic<float>* cabinetParam = nullptr;
+    std::atomic<float>* impulseResponseParam = nullptr;
+    std::atomic<float>* dynamicsParam = nullptr;
+    std::atomic<float>* attackParam = nullptr;
+    std::atomic<float>* releaseParam = nullptr;
+    std::atomic<float>* detectorParam = nullptr;
+    std::atomic<float>* keyParam = nullptr;
+    std::atomic<float>* duckParam = nullptr;
+    juce::RangedAudioParameter* stateParameters[StateFormat::numParameters] = {};
+
+    static constexpr int numBands = MultibandShaper<float>::maxBands;
+    static constexpr int numCrossovers = numBands - 1;
+    std::atomic<float>* bandsParam = nullptr;
+    std::atomic<float>* crossoverParams[numCrossovers] = {};
+    std::atomic<float>* bandParams[numBands][MultibandShaper<float>::numBandParameters] = {};
+
+    /** Everything the engines take from the parameters, read once per callback
+        so the main engine and every offline lane get exactly the same values.
+    */
+    struct EngineSettings
+    {
+        int quality = 0, filter = 0, table = ShaperTable::off, curve = 0;
+        float targets[numAutomatedParameters] = {};
+        bool retarget[numAutomatedParameters] = {};
+        float lowCut = 0, emphasis = 0, bass = 0, mid = 0, treble = 0, cabinet = 0;
+        float depth = 0, duck = 0, attack = 0, release = 0;
+        bool rms = false;
+        int bands = 1;      // active bands, 1 is the full-band shaper
+        float crossovers[numCrossovers] = {};
+        float bandValues[numBands][MultibandShaper<float>::numBandParameters] = {};
+        bool offline = false;
+    };
+
+    /** A chunk of an offline callback, as the serial loop would have split it. */
+    struct SubBlock
+    {
+        int start = 0, end = 0;
+        int firstEvent = 0, numEvents = 0;
+    };
+
+    /** The extra engines of a parallel offline render, one per channel group,
+        and the chunk they're working on.
+    */
+    template <typename SampleType>
+    struct OfflineLanes
+    {
+        juce::OwnedArray<DistortionEngine<SampleType>> engines;
+        int numChannels = 0;
+
+        // The chunk's whole bus before processing: every group's detector and
+        // silence check read it while the groups overwrite the host buffer
+        juce::AudioBuffer<SampleType> input;
+
+        juce::HeapBlock<ParameterEventQueue::Event> events;
+        juce::HeapBlock<SubBlock> subBlocks;
+        int maxEvents = 0;
+        bool skipped[WorkStealingPool::maxTasks] = {};
+    };
+
+    EngineSettings readEngineSettings() noexcept;
+
+    /** Returns true when the oversampling stage changed. */
+    template <typename SampleType>
+    bool applyEngineSettings (DistortionEngine<SampleType>&, const EngineSettings&) noexcept;
+
+    template <typename SampleType>
+    void prepareEngine (DistortionEngine<SampleType>&, double sampleRate, int samplesPerBlock, int numChannels, const EngineSettings&);
+
+    template <typename SampleType>
+    void prepareLanes (OfflineLanes<SampleType>&, double sampleRate, int samplesPerBlock, int numChannels, const EngineSettings&);
+
+    template <typename SampleType>
+    void processSamples (juce::AudioBuffer<SampleType>&, DistortionEngine<SampleType>&, OfflineLanes<SampleType>&);
+
+    template <typename SampleType>
+    bool processLanes (juce::dsp::AudioBlock<SampleType>, juce::dsp::AudioBlock<SampleType> key, bool keyIsInput,
+                       OfflineLanes<SampleType>&) noexcept;
+
+    ShaperTable shaperTable;
+    CabinetConvolver cabinetConvolver;
+    bool impulseResponseWasEnabled = false;
+    DistortionEngine<float> floatEngine { shaperTable };
+    DistortionEngine<double> doubleEngine { shaperTable };
+
+    // Only set up when prepared for an offline render
+    int maxOfflineThreads = 0;
+    std::unique_ptr<WorkStealingPool> offlinePool;
+    OfflineLanes<float> floatLanes;
+    OfflineLanes<double> doubleLanes;
+
+    ParameterEventQueue parameterEvents;
+    LevelMeter levelMeter;
+
+    // Filled once the parameters exist, from their defaults
+    PresetBank presets;
+    std::atomic<int> currentProgram { 0 };
+    juce::int64 renderPosition = 0;
+
+    // Written by the audio thread whenever the oversampling stage changes
+    std::atomic<int> tailLengthSamples { 0 };
+    std::atomic<int> pendingLatencySamples { 0 };
+
+    // Single writer (the audio thread), like the profiler's counters
+    std::atomic<juce::uint32> numProcessedBlocks { 0 }, numSkippedBlocks { 0 };
+
+   #if JULESAMP_ENABLE_PROFILER
+    CallbackProfiler profiler;
+   #endif
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JulesAmpAudioProcessor)
 };
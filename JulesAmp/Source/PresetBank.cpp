@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+void Preset::setName (const juce::String& newName) noexcept
+{
+    newName.copyToUTF8 (name, (size_t) maxNameLength);
+}
+
+namespace
+{
+    struct FactoryPreset
+    {
+        const char* name;
+        const char* changes;    // "id:value,id:value", in parameter units
+    };
+
+    // The first entry is the parameters' defaults
+    const FactoryPreset factoryPresets[] =
+    {
+        { "Default",           "" },
+        { "Edge of Breakup",   "drive:0.5,range:20,blend:0.6,volume:1.4" },
+        { "Crunch",            "drive:0.7,range:80,blend:0.8,volume:1.2,quality:1" },
+        { "Lead",              "drive:0.9,range:400,quality:2" },
+        { "Fuzz Wall",         "range:1500,volume:0.8,quality:2" },
+        { "Clean Boost",       "drive:0,blend:0,volume:3" }
+    };
+
+    int findParameter (const juce::String& id) noexcept
+    {
+        for (int i = 0; i < StateFormat::numParameters; ++i)
+            if (id == StateFormat::parameterIDs[i])
+                return i;
+
+        return -1;
+    }
+}
+
+void PresetBank::addFactoryPresets (const float (&defaults)[StateFormat::numParameters])
+{
+    for (auto& factory : factoryPresets)
+    {
+        Preset preset;
+        preset.setName (factory.name);
+        std::copy (std::begin (defaults), std::end (defaults), preset.values);
+
+        for (auto& change : juce::StringArray::fromTokens (factory.changes, ",", {}))
+        {
+            const auto index = findParameter (change.upToFirstOccurrenceOf (":", false, false));
+            jassert (index >= 0);
+
+            if (index >= 0)
+                preset.values[index] = change.fromFirstOccurrenceOf (":", false, false).getFloatValue();
+        }
+
+        add (preset);
+    }
+}
+
+const Preset* PresetBank::getPreset (int index) const noexcept
+{
+    return juce::isPositiveAndBelow (index, numPresets) ? &presets[index] : nullptr;
+}
+
+bool PresetBank::add (const Preset& preset) noexcept
+{
+    if (numPresets >= capacity)
+        return false;
+
+    presets[numPresets++] = preset;
+    return true;
+}
+
+void PresetBank::rename (int index, const juce::String& newName) noexcept
+{
+    if (juce::isPositiveAndBelow (index, numPresets))
+        presets[index].setName (newName);
+}
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 17 Oct 2026
+
+    The programs the host sees. A preset holds a value for every parameter
+    the state saves, in StateFormat's order. They're plain structs filled in
+    once when the bank is built, so switching program never parses or
+    allocates: the processor sets each parameter, and the audio thread
+    glides to the new values the way it follows any other change.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "StateFormat.h"
+
+struct Preset
+{
+    static constexpr int maxNameLength = 32;
+
+    char name[maxNameLength] = {};
+    float values[StateFormat::numParameters] = {};  // in parameter units, choices as indices
+
+    void setName (const juce::String&) noexcept;
+};
+
+class PresetBank
+{
+public:
+    static constexpr int capacity = 32;
+
+    PresetBank() = default;
+
+    /** Message thread. Adds the factory presets, each one these parameter
+        values with a few of them changed.
+    */
+    void addFactoryPresets (const float (&defaults)[StateFormat::numParameters]);
+
+    int size() const noexcept                           { return numPresets; }
+
+    /** Returns nullptr for an index outside the bank. */
+    const Preset* getPreset (int index) const noexcept;
+
+    /** Message thread. Returns false when the bank is full. */
+    bool add (const Preset&) noexcept;
+
+    /** Message thread. Names are never read by the audio thread. */
+    void rename (int index, const juce::String& newName) noexcept;
+
+private:
+    Preset presets[capacity];
+    int numPresets = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBank)
+};
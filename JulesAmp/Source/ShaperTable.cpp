@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    ShaperTable.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ShaperTable.h"
+#include "SharedResources.h"
+#include "WaveshaperKernels.h"
+
+ShaperTable::ShaperTable()
+{
+    resources->addClient (*this);
+}
+
+ShaperTable::~ShaperTable()
+{
+    resources->removeClient (*this);
+
+    // Let go of our tables before waking the builder, so it can purge them
+    for (auto& table : tables)
+        table = nullptr;
+
+    resources->wakeBuilder();
+}
+
+namespace
+{
+    int getOctaveBits (int resolution) noexcept
+    {
+        switch (resolution)
+        {
+            case ShaperTable::low:    return 5;
+            case ShaperTable::medium: return 6;
+            case ShaperTable::high:   return 8;
+            default:                  return 0;
+        }
+    }
+
+    uint32_t toBits (float value) noexcept
+    {
+        uint32_t bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        return bits;
+    }
+
+    float fromBits (uint32_t bits) noexcept
+    {
+        float value;
+        std::memcpy (&value, &bits, sizeof (value));
+        return value;
+    }
+}
+
+int ShaperTable::getNumSegments (int resolution) noexcept
+{
+    if (resolution == off)
+        return 0;
+
+    const auto octaveBits = getOctaveBits (resolution);
+    return (topExponent + octaveBits) << octaveBits;
+}
+
+double ShaperTable::getMaxError (int resolution) noexcept
+{
+    switch (resolution)
+    {
+        case low:    return 4.0e-4;
+        case medium: return 1.0e-4;
+        case high:   return 7.0e-6;
+        default:     return 0;
+    }
+}
+
+bool ShaperTable::beatsDirectPath (int curve, bool referenceMaths) noexcept
+{
+    return curve == WaveshaperKernels::atanCurve
+        || (curve == WaveshaperKernels::tanhCurve && referenceMaths);
+}
+
+//==============================================================================
+void ShaperTable::requestSettings (const Settings& settings) noexcept
+{
+    const auto packed = settings.resolution | (settings.curve << 8);
+
+    if (packed == lastRequest)
+        return;
+
+    lastRequest = packed;
+    request.store (packed, std::memory_order_release);
+    resources->wakeBuilder();
+}
+
+const ShaperTable::Table* ShaperTable::getTableFor (const Settings& settings) noexcept
+{
+    if ((middle.load (std::memory_order_acquire) & freshFlag) != 0)
+        readIndex = middle.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+
+    auto* table = tables[readIndex].get();
+
+    // A table built from a torn or outdated request simply never matches.
+    return table != nullptr && table->settings == settings ? table : nullptr;
+}
+
+template <typename SampleType>
+void ShaperTable::process (const Table& table, SampleType* data, int numSamples,
+                           SampleType gain, SampleType blend, SampleType volume) noexcept
+{
+    // w = |u| + 1 / S is a float whose exponent picks the octave and whose
+    // top octaveBits mantissa bits the segment within it, so its bits less
+    // those of 1 / S are the segment index followed by the offset into it.
+    const auto shift = 23 - table.octaveBits;
+    const auto offset = 1.0f / (float) (1 << table.octaveBits);
+    const auto offsetBits = toBits (offset);
+    const auto limit = (uint32_t) table.numSegments << shift;
+    const auto fractionMask = (1u << shift) - 1;
+    const auto fractionScale = 1.0f / (float) (1u << shift);
+    const auto* positive = table.values.get();
+    const auto* negative = positive + table.numSegments + 1;
+
+    const auto wetGain = blend * volume * (SampleType) 0.5;
+    const auto dryGain = ((SampleType) 1 - blend) * volume * (SampleType) 0.5;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = data[i];
+        auto u = x * gain;
+
+        // The period is 4, so the scaling and the fold are both exact
+        if (table.folded)
+            u -= (SampleType) 4 * std::floor (u * (SampleType) 0.25 + (SampleType) 0.5);
+
+        const auto argument = (float) u;
+        const auto position = toBits (std::abs (argument) + offset) - offsetBits;
+        SampleType shaped;
+
+        if (position < limit)
+        {
+            const auto* values = (argument < 0 ? negative : positive) + (position >> shift);
+            const auto fraction = (float) (position & fractionMask) * fractionScale;
+            shaped = (SampleType) (values[0] + fraction * (values[1] - values[0]));
+        }
+        else
+        {
+            shaped = (SampleType) evaluate ((double) u, table.settings.curve);
+        }
+
+        data[i] = shaped * wetGain + x * dryGain;
+    }
+}
+
+template void ShaperTable::process<float> (const Table&, float*, int, float, float, float) noexcept;
+template void ShaperTable::process<double> (const Table&, double*, int, double, double, double) noexcept;
+
+namespace
+{
+    using CurveFunction = double (*) (double) noexcept;
+
+    struct CurveFactory
+    {
+        template <typename Curve>
+        CurveFunction make() const noexcept
+        {
+            return [] (double x) noexcept { return Curve::outputScale * Curve::reference (x); };
+        }
+    };
+}
+
+double ShaperTable::evaluate (double u, int curve) noexcept
+{
+    return WaveshaperKernels::forCurve (curve, CurveFactory()) (u);
+}
+
+//==============================================================================
+void ShaperTable::build (Table& table, const Settings& settings)
+{
+    table.settings = settings;
+    table.octaveBits = getOctaveBits (settings.resolution);
+    table.numSegments = getNumSegments (settings.resolution);
+    table.folded = settings.curve == WaveshaperKernels::foldbackCurve;
+    table.values.allocate (2 * (size_t) (table.numSegments + 1), false);
+
+    const auto shift = 23 - table.octaveBits;
+    const auto offset = 1.0f / (float) (1 << table.octaveBits);
+    auto* negative = table.values.get() + table.numSegments + 1;
+
+    for (int i = 0; i <= table.numSegments; ++i)
+    {
+        // Exact in double, so the points sit where process() indexes them
+        const auto u = (double) fromBits (toBits (offset) + ((uint32_t) i << shift)) - (double) offset;
+
+        table.values[i] = (float) evaluate (u, settings.curve);
+        negative[i] = (float) evaluate (-u, settings.curve);
+    }
+}
+
+void ShaperTable::serviceRequest (SharedResources& pool)
+{
+    const auto packed = request.load (std::memory_order_acquire);
+
+    Settings requested;
+    requested.resolution = packed & 0xff;
+    requested.curve = packed >> 8;
+
+    // Only look for a new table when the curve or resolution changed since the last one.
+    if (requested.resolution == off || requested == built)
+        return;
+
+    tables[writeIndex] = pool.getTable (requested);
+    writeIndex = middle.exchange (writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+    built = requested;
+}
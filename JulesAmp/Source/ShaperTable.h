@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    ShaperTable.h
+    Created: 17 Oct 2026
+
+    Optional lookup-table mode for the shaper. A background thread tabulates
+    the selected curve, and the audio thread does a fetch and a lerp per
+    sample instead of evaluating it. Blend and Volume are linear, so they're
+    applied around the lookup rather than baked into the table.
+
+    The table is indexed by the curve's argument u = x * drive * range, not
+    by the input sample, so its accuracy doesn't depend on the gain. A grid
+    over the input would put the whole knee of a curve driven at 1500 within
+    one segment. The grid is logarithmic in w = |u| + 1 / S, with S segments
+    per octave, so the segment and its offset within it come straight from
+    the bits of w as a float: no divide, no log. Points crowd in where the
+    curves bend and thin out along the flat tails, and u = 1, where hard
+    clip, cubic and foldback have their corners, falls on a grid point. Each
+    sign gets its own half, which keeps the diode's asymmetric knee exact.
+    Foldback never flattens, but it repeats every 4, so it's reduced to one
+    period first.
+
+    A fetch and a lerp is only cheaper than the curve itself when the curve
+    is evaluated a sample at a time. The vector kernels shape 4 or 8 samples
+    for about what one lookup costs, so the engine only swaps the table in
+    for the scalar and reference implementations, and only for the curves
+    beatsDirectPath() names.
+
+    Tables only change with the curve and resolution, are built by
+    SharedResources' thread, and are shared by every instance asking for the
+    same ones. This class is each instance's lock-free window onto them.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class SharedResources;
+
+class ShaperTable
+{
+public:
+    /** Choices of the "table" parameter, trading accuracy for cache footprint. */
+    enum Resolution
+    {
+        off = 0,
+        low,        // 32 segments per octave
+        medium,     // 64
+        high        // 256
+    };
+
+    /** Segments per sign, over the octaves from 1 / S up to 2^topExponent. */
+    static int getNumSegments (int resolution) noexcept;
+
+    /** Max absolute error of a table at this resolution against the exact
+        curve, normalised to +-1, over every curve and every finite argument.
+        Cubic bends hardest and sets it; measured as 3.6e-4, 9.1e-5 and
+        5.7e-6, against 8.0e-5 or less for the others at low and exact to
+        float rounding for hard clip and foldback, whose corners sit on grid
+        points. The shaper's output error is this times Blend * Volume / 2.
+    */
+    static double getMaxError (int resolution) noexcept;
+
+    struct Settings
+    {
+        int resolution = off;
+        int curve = 0;      // Waveshaper::Curve
+
+        bool operator== (const Settings& other) const noexcept
+        {
+            return resolution == other.resolution && curve == other.curve;
+        }
+
+        bool operator!= (const Settings& other) const noexcept   { return ! operator== (other); }
+    };
+
+    struct Table  : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<Table>;
+
+        size_t getSizeInBytes() const noexcept     { return sizeof (float) * 2 * (size_t) (numSegments + 1); }
+
+        Settings settings;
+        int octaveBits = 0;             // log2 of the segments per octave
+        int numSegments = 0;            // per sign
+        bool folded = false;            // reduced to one period before the lookup
+        juce::HeapBlock<float> values;  // numSegments + 1 points for u >= 0, then as many for u <= 0
+    };
+
+    ShaperTable();
+    ~ShaperTable();
+
+    /** Whether a lookup beats shaping this curve a sample at a time, with the
+        scalar kernels or, given referenceMaths, with std:: maths. Only the
+        transcendental curves cost more than a fetch and a lerp: atan either
+        way, tanh only through std::tanh. Hard clip, diode and cubic are a
+        handful of operations, and foldback's period reduction costs about
+        as much as the fold itself.
+    */
+    static bool beatsDirectPath (int curve, bool referenceMaths) noexcept;
+
+    /** Arguments from 2^topExponent out, and NaNs, are shaped directly. Every
+        curve but foldback, which is reduced first, has long settled there.
+    */
+    static constexpr int topExponent = 14;
+
+    /** Audio thread: asks for a table matching these settings. Lock-free
+        when they're the same as last time; a changed request wakes the
+        shared builder thread, which otherwise sleeps.
+    */
+    void requestSettings (const Settings&) noexcept;
+
+    /** Audio thread: returns the newest published table if it was built for
+        exactly these settings, otherwise nullptr (use the direct path). The
+        table stays valid until the next call.
+    */
+    const Table* getTableFor (const Settings&) noexcept;
+
+    /** Shapes a float or double block through the table, with the same
+        gain, blend and volume as Waveshaper::process.
+    */
+    template <typename SampleType>
+    static void process (const Table&, SampleType* data, int numSamples,
+                         SampleType gain, SampleType blend, SampleType volume) noexcept;
+
+    /** The exact curve at argument u, normalised to +-1. Fills the tables,
+        and shapes the odd sample a table can't index (far out, NaNs).
+    */
+    static double evaluate (double u, int curve) noexcept;
+
+    /** Fills a table for these settings. SharedResources calls this on its
+        builder thread; it's public so tests can check a table directly.
+    */
+    static void build (Table&, const Settings&);
+
+private:
+    friend class SharedResources;
+
+    /** Builder thread: fetches a table for the latest request if it changed,
+        and publishes it.
+    */
+    void serviceRequest (SharedResources&);
+
+    static constexpr int freshFlag = 4, indexMask = 3;
+
+    // Triple buffer: the builder owns writeIndex, the audio thread owns
+    // readIndex, and the spare slot is handed over through middle. Only the
+    // builder assigns slots, so a replaced table is released on its thread.
+    Table::Ptr tables[3];
+    std::atomic<int> middle { 1 };
+    int writeIndex = 2, readIndex = 0;
+    Settings built;
+
+    juce::SharedResourcePointer<SharedResources> resources;
+
+    // Resolution and curve packed into one word, so the builder never sees
+    // half of a request. lastRequest is the audio thread's own copy.
+    std::atomic<int> request { off };
+    int lastRequest = off;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ShaperTable)
+};
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    SharedResources.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "SharedResources.h"
+
+SharedResources::SharedResources()
+    : juce::Thread ("JulesAmp shared resources")
+{
+    startThread();
+}
+
+SharedResources::~SharedResources()
+{
+    // Every ShaperTable holds a SharedResourcePointer, so they're all gone by now
+    jassert (clients.isEmpty());
+    stopThread (1000);
+}
+
+void SharedResources::addClient (ShaperTable& client)
+{
+    const juce::ScopedLock sl (clientLock);
+    clients.addIfNotAlreadyThere (&client);
+}
+
+void SharedResources::removeClient (ShaperTable& client)
+{
+    // Waits for the builder to finish with it, if it's serving it right now
+    const juce::ScopedLock sl (clientLock);
+    clients.removeFirstMatchingValue (&client);
+}
+
+//==============================================================================
+ShaperTable::Table::Ptr SharedResources::getTable (const ShaperTable::Settings& settings)
+{
+    for (auto* table : tables)
+        if (table->settings == settings)
+            return table;
+
+    ShaperTable::Table::Ptr table (new ShaperTable::Table());
+    ShaperTable::build (*table, settings);
+
+    tables.add (table);
+    numTables.store (tables.size(), std::memory_order_relaxed);
+    tableBytes.store (tableBytes.load (std::memory_order_relaxed) + table->getSizeInBytes(), std::memory_order_relaxed);
+    return table;
+}
+
+void SharedResources::purgeTables()
+{
+    // The cache's own reference is the last one: no instance plays it any more
+    for (int i = tables.size(); --i >= 0;)
+    {
+        if (tables.getObjectPointerUnchecked (i)->getReferenceCount() == 1)
+        {
+            tableBytes.store (tableBytes.load (std::memory_order_relaxed) - tables.getObjectPointerUnchecked (i)->getSizeInBytes(),
+                              std::memory_order_relaxed);
+            tables.remove (i);
+        }
+    }
+
+    numTables.store (tables.size(), std::memory_order_relaxed);
+}
+
+void SharedResources::run()
+{
+    while (! threadShouldExit())
+    {
+        {
+            const juce::ScopedLock sl (clientLock);
+
+            for (auto* client : clients)
+                client->serviceRequest (*this);
+        }
+
+        purgeTables();
+
+        // Every request is served by now; sleep until a client changes one
+        wait (-1);
+    }
+}
+
+//==============================================================================
+SharedResources::ImpulseResponse::Ptr SharedResources::getImpulseResponse (const juce::File& file, double maxSeconds)
+{
+    const juce::ScopedLock sl (impulseResponseLock);
+    const auto modificationTime = file.getLastModificationTime();
+
+    for (int i = impulseResponses.size(); --i >= 0;)
+    {
+        auto* ir = impulseResponses.getObjectPointerUnchecked (i);
+
+        if (ir->file == file && ir->modificationTime == modificationTime && ir->maxSeconds == maxSeconds)
+            return ir;
+
+        // Nobody else holds it, drop it while we're here
+        if (ir->getReferenceCount() == 1)
+            impulseResponses.remove (i);
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return nullptr;
+
+    const auto numSamples = (int) juce::jmin (reader->lengthInSamples, (juce::int64) (reader->sampleRate * maxSeconds));
+    const auto numChannels = juce::jlimit (1, 2, (int) reader->numChannels);
+
+    ImpulseResponse::Ptr ir (new ImpulseResponse());
+    ir->file = file;
+    ir->modificationTime = modificationTime;
+    ir->maxSeconds = maxSeconds;
+    ir->sampleRate = reader->sampleRate;
+    ir->buffer.setSize (numChannels, numSamples);
+
+    if (! reader->read (&ir->buffer, 0, numSamples, 0, true, numChannels > 1))
+        return nullptr;
+
+    impulseResponses.add (ir);
+    return ir;
+}
+
+SharedResources::Stats SharedResources::getStats() const
+{
+    Stats stats;
+
+    {
+        const juce::ScopedLock sl (clientLock);
+        stats.numClients = clients.size();
+    }
+
+    stats.numTables = numTables.load (std::memory_order_relaxed);
+    stats.tableBytes = tableBytes.load (std::memory_order_relaxed);
+
+    const juce::ScopedLock sl (impulseResponseLock);
+    stats.numImpulseResponses = impulseResponses.size();
+
+    for (auto* ir : impulseResponses)
+        stats.impulseResponseBytes += sizeof (float) * (size_t) (ir->buffer.getNumChannels() * ir->buffer.getNumSamples());
+
+    return stats;
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    SharedResources.h
+    Created: 17 Oct 2026
+
+    Process-wide cache of the immutable DSP resources JulesAmp builds, shared
+    by every instance in the host through juce::SharedResourcePointer and
+    destroyed with the last one.
+
+    Shaper tables: a single background thread serves every instance's
+    ShaperTable requests, and instances asking for the same settings get the
+    same reference-counted table. Cabinet IRs: each file is decoded once, on
+    the message thread, and every instance loading it copies from there.
+
+    Nothing in here is ever released on the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ShaperTable.h"
+
+class SharedResources  : private juce::Thread
+{
+public:
+    struct ImpulseResponse  : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<ImpulseResponse>;
+
+        juce::File file;
+        juce::Time modificationTime;
+        double maxSeconds = 0;
+
+        juce::AudioBuffer<float> buffer;    // one or two channels, at most maxSeconds long
+        double sampleRate = 0;
+    };
+
+    struct Stats
+    {
+        int numClients = 0;
+        int numTables = 0;
+        int numImpulseResponses = 0;
+        size_t tableBytes = 0, impulseResponseBytes = 0;
+    };
+
+    SharedResources();
+    ~SharedResources() override;
+
+    /** Any thread but the audio thread. The table builder serves registered
+        tables' requests until they're removed again.
+    */
+    void addClient (ShaperTable&);
+    void removeClient (ShaperTable&);
+
+    /** Message thread. Decodes the file on first use, later calls for the same
+        unchanged file and cap share that. Returns nullptr if it isn't audio.
+    */
+    ImpulseResponse::Ptr getImpulseResponse (const juce::File&, double maxSeconds);
+
+    /** Any thread. */
+    Stats getStats() const;
+
+private:
+    friend class ShaperTable;
+
+    /** Any thread: a client's request changed, or tables may have been let go. */
+    void wakeBuilder() noexcept     { notify(); }
+
+    /** Builder thread: the cached table for these settings, built if needed. */
+    ShaperTable::Table::Ptr getTable (const ShaperTable::Settings&);
+
+    void run() override;
+    void purgeTables();
+
+    juce::CriticalSection clientLock;
+    juce::Array<ShaperTable*> clients;
+
+    // Only the builder thread touches the tables, the counters are for getStats()
+    juce::ReferenceCountedArray<ShaperTable::Table> tables;
+    std::atomic<int> numTables { 0 };
+    std::atomic<size_t> tableBytes { 0 };
+
+    juce::CriticalSection impulseResponseLock;
+    juce::ReferenceCountedArray<ImpulseResponse> impulseResponses;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedResources)
+};
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    StateFormat.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "StateFormat.h"
+
+namespace StateFormat
+{
+    // magic, version, value count, program
+    constexpr int headerSize = 4 + 2 + 2 + 4;
+
+    void write (const State& state, juce::MemoryBlock& dest)
+    {
+        juce::MemoryOutputStream out (dest, false);
+        out.preallocate ((size_t) (headerSize + numParameters * 4) + state.impulseResponse.getNumBytesAsUTF8() + 1);
+
+        // The stream writes little-endian whatever the platform
+        out.writeInt ((int) magic);
+        out.writeShort ((short) currentVersion);
+        out.writeShort ((short) numParameters);
+        out.writeInt (state.program);
+
+        for (auto value : state.values)
+            out.writeFloat (value);
+
+        out.writeString (state.impulseResponse);
+    }
+
+    bool read (const void* data, int sizeInBytes, State& state)
+    {
+        if (data == nullptr || sizeInBytes < headerSize)
+            return false;
+
+        juce::MemoryInputStream in (data, (size_t) sizeInBytes, false);
+
+        if ((juce::uint32) in.readInt() != magic)
+            return false;
+
+        // Every version so far shares this header. A newer blob may carry
+        // values we don't know about, those are skipped.
+        auto version = (int) (juce::uint16) in.readShort();
+        auto numValues = (int) (juce::uint16) in.readShort();
+
+        if (version < 1 || sizeInBytes < headerSize + numValues * 4)
+            return false;
+
+        state.program = in.readInt();
+        state.normalised = version >= 3;
+        state.numValues = juce::jmin (numValues, numParameters);
+
+        for (int i = 0; i < state.numValues; ++i)
+            state.values[i] = in.readFloat();
+
+        in.skipNextBytes ((juce::int64) (numValues - state.numValues) * 4);
+
+        if (version >= 2 && ! in.isExhausted())
+            state.impulseResponse = in.readString();
+
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    StateFormat.h
+    Created: 17 Oct 2026
+
+    The plugin's saved state: a small versioned header followed by the
+    parameter values packed as little-endian floats, then (from version 2)
+    the cabinet impulse response's path as a UTF-8 string. Restoring reads a fixed
+    number of bytes, no ValueTree is built. Blobs written before this format
+    existed are serialised ValueTrees and are recognised by their missing magic.
+
+    From version 3 the values are the parameters' normalised 0..1 values,
+    which is what a parameter is set from, so a round trip restores them
+    bit for bit. Versions 1 and 2 stored them in parameter units, and
+    converting those back could land a rounding step away.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace StateFormat
+{
+    /** "JAmp", little-endian. */
+    constexpr juce::uint32 magic = 0x706d414a;
+
+    /** Bump when the layout changes; readers keep accepting older versions. */
+    constexpr int currentVersion = 3;
+
+    /** Every saved parameter, in packing order. New parameters are only ever
+        appended, so an older blob is a prefix of a newer one.
+    */
+    constexpr const char* parameterIDs[] = { "drive", "range", "blend", "volume", "quality", "filter", "table",
+                                             "bands", "crossover1", "crossover2", "crossover3",
+                                             "drive1", "range1", "blend1", "drive2", "range2", "blend2",
+                                             "drive3", "range3", "blend3", "drive4", "range4", "blend4",
+                                             "curve", "lowcut", "emphasis", "bass", "mid", "treble", "cabinet",
+                                             "ir", "dynamics", "attack", "release", "detector",
+                                             "key", "duck" };
+    constexpr int numParameters = (int) (sizeof (parameterIDs) / sizeof (parameterIDs[0]));
+
+    struct State
+    {
+        float values[numParameters] = {};
+        bool normalised = true;             // 0..1 values, otherwise in parameter units (before version 3)
+        int numValues = 0;                  // how many values the blob held, the rest keep their defaults
+        int program = 0;
+        juce::String impulseResponse;       // full path, empty when no IR is loaded
+    };
+
+    void write (const State&, juce::MemoryBlock&);
+
+    /** Returns false when the data isn't in this format (a legacy blob, or garbage). */
+    bool read (const void* data, int sizeInBytes, State&);
+}
@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+    Waveshaper.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "Waveshaper.h"
+#include "WaveshaperKernels.h"
+
+namespace
+{
+    template <typename SampleType, typename Curve>
+    void shapeReference (SampleType* const* channels, int numChannels, int numSamples,
+                         SampleType gain, SampleType blend, SampleType volume)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = channels[channel];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                SampleType cleanSig = data[i];
+                SampleType shaped = (SampleType) (Curve::outputScale * Curve::reference ((double) (cleanSig * gain)));
+                data[i] = ((shaped * blend + cleanSig * (1 - blend)) / 2) * volume;
+            }
+        }
+    }
+
+    template <typename SampleType, typename Curve>
+    void shapeReferenceRamped (SampleType* const* channels, int numChannels, int numSamples,
+                               const SampleType* gain, const SampleType* blend, const SampleType* volume)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto* data = channels[channel] + i;
+                shapeReference<SampleType, Curve> (&data, 1, 1, gain[i], blend[i], volume[i]);
+            }
+        }
+    }
+
+    template <typename Ops, typename Curve>
+    void shape (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                typename Ops::Sample gain, typename Ops::Sample blend, typename Ops::Sample volume)
+    {
+        WaveshaperKernels::shape<Ops, Curve> (channels, numChannels, numSamples, gain, blend, volume);
+    }
+
+    template <typename Ops, typename Curve>
+    void shapeRamped (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                      const typename Ops::Sample* gain, const typename Ops::Sample* blend,
+                      const typename Ops::Sample* volume)
+    {
+        WaveshaperKernels::shapeRamped<Ops, Curve> (channels, numChannels, numSamples, gain, blend, volume);
+    }
+
+    template <typename Ops>
+    struct KernelFactory
+    {
+        template <typename Curve>
+        typename Waveshaper<typename Ops::Sample>::Kernels make() const
+        {
+            return { shape<Ops, Curve>, shapeRamped<Ops, Curve> };
+        }
+    };
+
+    template <typename SampleType>
+    struct ReferenceFactory
+    {
+        template <typename Curve>
+        typename Waveshaper<SampleType>::Kernels make() const
+        {
+            return { shapeReference<SampleType, Curve>, shapeReferenceRamped<SampleType, Curve> };
+        }
+    };
+
+    template <typename Ops>
+    typename Waveshaper<typename Ops::Sample>::Kernels makeKernels (int curve)
+    {
+        return WaveshaperKernels::forCurve (curve, KernelFactory<Ops>());
+    }
+
+    // Overloaded on the sample type, since not every instruction set has double lanes.
+    Waveshaper<float>::Kernels getSSE2Kernels (float, int curve)
+    {
+       #if JULESAMP_SSE2
+        return makeKernels<WaveshaperKernels::SSE2FloatOps> (curve);
+       #else
+        juce::ignoreUnused (curve);
+        return {};
+       #endif
+    }
+
+    Waveshaper<double>::Kernels getSSE2Kernels (double, int curve)
+    {
+       #if JULESAMP_SSE2
+        return makeKernels<WaveshaperKernels::SSE2DoubleOps> (curve);
+       #else
+        juce::ignoreUnused (curve);
+        return {};
+       #endif
+    }
+
+    Waveshaper<float>::Kernels getNEONKernels (float, int curve)
+    {
+       #if JULESAMP_NEON
+        return makeKernels<WaveshaperKernels::NEONFloatOps> (curve);
+       #else
+        juce::ignoreUnused (curve);
+        return {};
+       #endif
+    }
+
+    Waveshaper<double>::Kernels getNEONKernels (double, int curve)
+    {
+       #if JULESAMP_NEON64
+        return makeKernels<WaveshaperKernels::NEONDoubleOps> (curve);
+       #else
+        juce::ignoreUnused (curve);
+        return {};
+       #endif
+    }
+}
+
+static_assert ((int) Waveshaper<float>::numCurves == (int) WaveshaperKernels::numCurves,
+               "The curve parameter and the kernel table must list the same curves");
+
+//==============================================================================
+template <typename SampleType>
+Waveshaper<SampleType>::Waveshaper()
+{
+    setImplementation (getBestImplementation());
+}
+
+template <typename SampleType>
+void Waveshaper<SampleType>::setImplementation (Implementation newImplementation)
+{
+    implementation = isSupported (newImplementation) ? newImplementation
+                                                     : getBestImplementation();
+
+    for (int c = 0; c < numCurves; ++c)
+        kernels[c] = getKernels (implementation, c);
+}
+
+template <typename SampleType>
+bool Waveshaper<SampleType>::isSupported (Implementation impl)
+{
+    auto k = getKernels (impl, atanCurve);
+    return k.constant != nullptr && k.ramped != nullptr;
+}
+
+template <typename SampleType>
+typename Waveshaper<SampleType>::Implementation Waveshaper<SampleType>::getBestImplementation()
+{
+    for (auto impl : { Implementation::avx2, Implementation::neon, Implementation::sse2 })
+        if (isSupported (impl))
+            return impl;
+
+    return Implementation::scalar;
+}
+
+template <typename SampleType>
+juce::String Waveshaper<SampleType>::getImplementationName (Implementation impl)
+{
+    switch (impl)
+    {
+        case Implementation::reference: return "Reference (std:: maths)";
+        case Implementation::scalar:    return "Scalar";
+        case Implementation::sse2:      return "SSE2";
+        case Implementation::avx2:      return "AVX2";
+        case Implementation::neon:      return "NEON";
+    }
+
+    return {};
+}
+
+template <typename SampleType>
+typename Waveshaper<SampleType>::Kernels Waveshaper<SampleType>::getKernels (Implementation impl, int curve)
+{
+    switch (impl)
+    {
+        case Implementation::reference: return WaveshaperKernels::forCurve (curve, ReferenceFactory<SampleType>());
+        case Implementation::scalar:    return makeKernels<WaveshaperKernels::ScalarOps<SampleType>> (curve);
+
+        case Implementation::sse2:
+            return getSSE2Kernels (SampleType(), curve);
+
+        case Implementation::avx2:
+            if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+                return getAVX2WaveshaperKernels<SampleType> (curve);
+
+            return {};
+
+        case Implementation::neon:
+            return getNEONKernels (SampleType(), curve);
+    }
+
+    return {};
+}
+
+//==============================================================================
+template <typename SampleType>
+void Waveshaper<SampleType>::prepare (int maximumBlockSize, int numChannels)
+{
+    fadeBuffer.setSize (juce::jmax (1, numChannels), juce::jmax (1, maximumBlockSize));
+    fadeRemaining = 0;
+}
+
+template <typename SampleType>
+void Waveshaper<SampleType>::setCurve (int newCurve, int fadeSamples) noexcept
+{
+    newCurve = juce::jlimit (0, numCurves - 1, newCurve);
+
+    if (newCurve == curve)
+        return;
+
+    // A switch mid-fade starts over from the curve currently playing
+    previousCurve = curve;
+    curve = newCurve;
+    fadeLength = fadeRemaining = juce::jmax (0, fadeSamples);
+}
+
+template <typename SampleType>
+SampleType* const* Waveshaper<SampleType>::copyToFadeBuffer (SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::copy (fadeBuffer.getWritePointer (channel), channels[channel], numSamples);
+
+    return fadeBuffer.getArrayOfWritePointers();
+}
+
+template <typename SampleType>
+void Waveshaper<SampleType>::mixFade (SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    // Linear crossfade, outgoing curve in fadeBuffer, incoming one in place
+    const auto numFading = juce::jmin (numSamples, fadeRemaining);
+    const auto step = (SampleType) 1 / (SampleType) fadeLength;
+    const auto start = (SampleType) (fadeLength - fadeRemaining) * step;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = channels[channel];
+        const auto* outgoing = fadeBuffer.getReadPointer (channel);
+
+        for (int i = 0; i < numFading; ++i)
+        {
+            const auto amount = start + (SampleType) (i + 1) * step;
+            data[i] = outgoing[i] + (data[i] - outgoing[i]) * amount;
+        }
+    }
+}
+
+template class Waveshaper<float>;
+template class Waveshaper<double>;
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    Waveshaper.h
+    Created: 17 Oct 2026
+
+    The distortion stage. A vectorised kernel is picked at runtime from the
+    CPU's feature set, with one instantiation per transfer curve; the
+    std:: maths path is kept as the reference the fast kernels are measured
+    against. Instantiated for float and double so double-precision hosts get
+    their own vector loops.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <typename SampleType>
+class Waveshaper
+{
+public:
+    /** Every kernel shapes numSamples of each channel in place with
+        (curve (x * gain) * blend + x * (1 - blend)) / 2 * volume
+    */
+    using Kernel = void (*) (SampleType* const* channels, int numChannels, int numSamples,
+                             SampleType gain, SampleType blend, SampleType volume);
+
+    /** The same curve with per-sample parameters shared by every channel,
+        used while smoothers are ramping.
+    */
+    using RampedKernel = void (*) (SampleType* const* channels, int numChannels, int numSamples,
+                                   const SampleType* gain, const SampleType* blend, const SampleType* volume);
+
+    struct Kernels
+    {
+        Kernel constant = nullptr;
+        RampedKernel ramped = nullptr;
+    };
+
+    enum class Implementation
+    {
+        reference,
+        scalar,
+        sse2,
+        avx2,
+        neon
+    };
+
+    /** Choices of the "curve" parameter, in WaveshaperKernels' curve order. */
+    enum Curve
+    {
+        atanCurve,
+        tanhCurve,
+        hardClipCurve,
+        diodeCurve,
+        foldbackCurve,
+        cubicCurve,
+        numCurves
+    };
+
+    /** Max absolute error of the polynomial kernels' atan against std::atan,
+        in radians, over every finite input (drive * range reaches 1500).
+    */
+    static constexpr double maxAtanError = 2.0e-7;
+
+    /** No curve's kernel may cost more than this times atan's on the same
+        implementation. Atan is the curve the shaper was built around, so no
+        choice of curve makes it more than this much dearer. Hard clip would
+        be a poor yardstick: it's barely more than the loads, stores and
+        blend around it. The reference implementation is exempt, since
+        std::tanh alone costs about twice std::atan.
+    */
+    static constexpr double maxCostAgainstAtan = 1.5;
+
+    Waveshaper();
+
+    /** Sizes the scratch buffer curve crossfades render into. */
+    void prepare (int maximumBlockSize, int numChannels);
+
+    /** Switches curve, crossfading from the old one over fadeSamples. The fade
+        only moves on when advanceFade() is called, so every band or channel
+        group shaped within one block sees the same fade position.
+    */
+    void setCurve (int newCurve, int fadeSamples) noexcept;
+    int getCurve() const noexcept                       { return curve; }
+    bool isFading() const noexcept                      { return fadeRemaining > 0; }
+    void advanceFade (int numSamples) noexcept          { fadeRemaining = juce::jmax (0, fadeRemaining - numSamples); }
+
+    /** Falls back to the best supported kernel if the CPU can't run the one asked for. */
+    void setImplementation (Implementation);
+    Implementation getImplementation() const noexcept   { return implementation; }
+
+    static bool isSupported (Implementation);
+    static Implementation getBestImplementation();
+    static juce::String getImplementationName (Implementation);
+
+    void process (SampleType* const* channels, int numChannels, int numSamples,
+                  SampleType gain, SampleType blend, SampleType volume) noexcept
+    {
+        auto fading = canFade (numChannels, numSamples);
+
+        if (fading)
+            kernels[previousCurve].constant (copyToFadeBuffer (channels, numChannels, numSamples),
+                                             numChannels, numSamples, gain, blend, volume);
+
+        kernels[curve].constant (channels, numChannels, numSamples, gain, blend, volume);
+
+        if (fading)
+            mixFade (channels, numChannels, numSamples);
+    }
+
+    void processRamped (SampleType* const* channels, int numChannels, int numSamples, const SampleType* gain,
+                        const SampleType* blend, const SampleType* volume) noexcept
+    {
+        auto fading = canFade (numChannels, numSamples);
+
+        if (fading)
+            kernels[previousCurve].ramped (copyToFadeBuffer (channels, numChannels, numSamples),
+                                           numChannels, numSamples, gain, blend, volume);
+
+        kernels[curve].ramped (channels, numChannels, numSamples, gain, blend, volume);
+
+        if (fading)
+            mixFade (channels, numChannels, numSamples);
+    }
+
+private:
+    static Kernels getKernels (Implementation, int curve);
+
+    bool canFade (int numChannels, int numSamples) const noexcept
+    {
+        return fadeRemaining > 0 && numChannels <= fadeBuffer.getNumChannels()
+                                 && numSamples <= fadeBuffer.getNumSamples();
+    }
+
+    SampleType* const* copyToFadeBuffer (SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    void mixFade (SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    Implementation implementation;
+    Kernels kernels[numCurves];
+
+    int curve = atanCurve, previousCurve = atanCurve;
+    int fadeLength = 0, fadeRemaining = 0;
+    juce::AudioBuffer<SampleType> fadeBuffer;
+
+    JUCE_LEAK_DETECTOR (Waveshaper)
+};
+
+/** Defined in WaveshaperAVX2.cpp, returns null kernels when that file wasn't built with AVX2 enabled. */
+template <typename SampleType>
+typename Waveshaper<SampleType>::Kernels getAVX2WaveshaperKernels (int curve);
+
+template <> Waveshaper<float>::Kernels getAVX2WaveshaperKernels<float> (int curve);
+template <> Waveshaper<double>::Kernels getAVX2WaveshaperKernels<double> (int curve);
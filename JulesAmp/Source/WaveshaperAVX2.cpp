@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    WaveshaperAVX2.cpp
+    Created: 17 Oct 2026
+
+    Built with the "AVX2" compiler flag scheme (/arch:AVX2, -mavx2 -mfma).
+    Only reached after Waveshaper has checked the CPU supports it.
+
+  ==============================================================================
+*/
+
+#include "Waveshaper.h"
+#include "WaveshaperKernels.h"
+
+#if JULESAMP_AVX2
+template <typename Ops, typename Curve>
+static void shapeAVX2 (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                       typename Ops::Sample gain, typename Ops::Sample blend, typename Ops::Sample volume)
+{
+    WaveshaperKernels::shape<Ops, Curve> (channels, numChannels, numSamples, gain, blend, volume);
+}
+
+template <typename Ops, typename Curve>
+static void shapeAVX2Ramped (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                             const typename Ops::Sample* gain, const typename Ops::Sample* blend,
+                             const typename Ops::Sample* volume)
+{
+    WaveshaperKernels::shapeRamped<Ops, Curve> (channels, numChannels, numSamples, gain, blend, volume);
+}
+
+template <typename Ops>
+struct AVX2KernelFactory
+{
+    template <typename Curve>
+    typename Waveshaper<typename Ops::Sample>::Kernels make() const
+    {
+        return { shapeAVX2<Ops, Curve>, shapeAVX2Ramped<Ops, Curve> };
+    }
+};
+#endif
+
+template <>
+Waveshaper<float>::Kernels getAVX2WaveshaperKernels<float> (int curve)
+{
+   #if JULESAMP_AVX2
+    return WaveshaperKernels::forCurve (curve, AVX2KernelFactory<WaveshaperKernels::AVX2FloatOps>());
+   #else
+    juce::ignoreUnused (curve);
+    return {};
+   #endif
+}
+
+template <>
+Waveshaper<double>::Kernels getAVX2WaveshaperKernels<double> (int curve)
+{
+   #if JULESAMP_AVX2
+    return WaveshaperKernels::forCurve (curve, AVX2KernelFactory<WaveshaperKernels::AVX2DoubleOps>());
+   #else
+    juce::ignoreUnused (curve);
+    return {};
+   #endif
+}
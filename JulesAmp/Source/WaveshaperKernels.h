@@ -0,0 +1,587 @@
+/*
+  ==============================================================================
+
+    WaveshaperKernels.h
+    Created: 17 Oct 2026
+
+    Instruction-set wrappers and the templated shaping loops they all share.
+    This header is included by Waveshaper.cpp (scalar/SSE2/NEON) and by
+    WaveshaperAVX2.cpp, which is compiled with the AVX2 compiler flag scheme,
+    so each translation unit only instantiates what its flags allow.
+
+    Everything here sits in an unnamed namespace. The same template
+    instantiated in two of those translation units would otherwise be one
+    symbol, and the linker could keep the AVX2 copy for the SSE2 path. For
+    the same reason the shaping loops finish a block with a padded vector
+    rather than scalar code, so the AVX2 unit never compiles ScalarOps or
+    the std:: maths it calls.
+
+    Every wrapper exposes the same static interface over one register type,
+    for float and for double, so the loops below are written once.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+
+#if defined (__SSE2__) || defined (_M_X64) || defined (_M_AMD64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define JULESAMP_SSE2 1
+ #include <emmintrin.h>
+#endif
+
+#if defined (__AVX2__)
+ #define JULESAMP_AVX2 1
+ #include <immintrin.h>
+#endif
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__)
+ #define JULESAMP_NEON 1
+ #include <arm_neon.h>
+
+ #if defined (__aarch64__) || defined (_M_ARM64)
+  #define JULESAMP_NEON64 1
+ #endif
+#endif
+
+namespace WaveshaperKernels
+{
+namespace
+{
+    // Minimax polynomial for atan on [0, 1] (Abramowitz & Stegun 4.4.49).
+    // Arguments above 1 are folded through atan (x) = pi/2 - atan (1/x), which
+    // keeps the approximation valid over the whole drive * range domain.
+    // Max absolute error against std::atan is below 2e-7 rad in float and
+    // 2e-8 rad in double.
+    constexpr double atanC2  = -0.3333314528;
+    constexpr double atanC4  =  0.1999355085;
+    constexpr double atanC6  = -0.1420889944;
+    constexpr double atanC8  =  0.1065626393;
+    constexpr double atanC10 = -0.0752896400;
+    constexpr double atanC12 =  0.0429096138;
+    constexpr double atanC14 = -0.0161657367;
+    constexpr double atanC16 =  0.0028662257;
+
+    constexpr double halfPi = 1.57079632679489661923;
+    constexpr double pi     = 3.14159265358979323846;
+
+    //==============================================================================
+    template <typename SampleType>
+    struct ScalarOps
+    {
+        using Sample = SampleType;
+        using Vec    = SampleType;
+        using Mask   = bool;
+        static constexpr int width = 1;
+
+        static Vec load (const Sample* p) noexcept                { return *p; }
+        static void store (Sample* p, Vec v) noexcept             { *p = v; }
+        static Vec set (Sample v) noexcept                        { return v; }
+        static Vec add (Vec a, Vec b) noexcept                    { return a + b; }
+        static Vec sub (Vec a, Vec b) noexcept                    { return a - b; }
+        static Vec mul (Vec a, Vec b) noexcept                    { return a * b; }
+        static Vec div (Vec a, Vec b) noexcept                    { return a / b; }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return a * b + c; }
+        static Vec abs (Vec a) noexcept                           { return std::abs (a); }
+        static Vec copySign (Vec mag, Vec sign) noexcept          { return std::copysign (mag, sign); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return a > b; }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return m ? a : b; }
+        static Vec min (Vec a, Vec b) noexcept                    { return a < b ? a : b; }
+        static Vec max (Vec a, Vec b) noexcept                    { return a > b ? a : b; }
+        static Vec floor (Vec a) noexcept                         { return std::floor (a); }
+    };
+
+   #if JULESAMP_SSE2
+    struct SSE2FloatOps
+    {
+        using Sample = float;
+        using Vec    = __m128;
+        using Mask   = __m128;
+        static constexpr int width = 4;
+
+        static Vec load (const float* p) noexcept                 { return _mm_loadu_ps (p); }
+        static void store (float* p, Vec v) noexcept              { _mm_storeu_ps (p, v); }
+        static Vec set (float v) noexcept                         { return _mm_set1_ps (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return _mm_add_ps (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return _mm_sub_ps (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return _mm_mul_ps (a, b); }
+        static Vec div (Vec a, Vec b) noexcept                    { return _mm_div_ps (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return _mm_add_ps (_mm_mul_ps (a, b), c); }
+        static Vec abs (Vec a) noexcept                           { return _mm_andnot_ps (_mm_set1_ps (-0.0f), a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return _mm_cmpgt_ps (a, b); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b)); }
+        static Vec min (Vec a, Vec b) noexcept                    { return _mm_min_ps (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return _mm_max_ps (a, b); }
+
+        // SSE2 has no rounding modes, truncate and step down where that rounded up
+        static Vec floor (Vec a) noexcept
+        {
+            const auto t = _mm_cvtepi32_ps (_mm_cvttps_epi32 (a));
+            return _mm_sub_ps (t, _mm_and_ps (_mm_cmpgt_ps (t, a), _mm_set1_ps (1.0f)));
+        }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            const auto signBit = _mm_set1_ps (-0.0f);
+            return _mm_or_ps (_mm_andnot_ps (signBit, mag), _mm_and_ps (signBit, sign));
+        }
+    };
+
+    struct SSE2DoubleOps
+    {
+        using Sample = double;
+        using Vec    = __m128d;
+        using Mask   = __m128d;
+        static constexpr int width = 2;
+
+        static Vec load (const double* p) noexcept                { return _mm_loadu_pd (p); }
+        static void store (double* p, Vec v) noexcept             { _mm_storeu_pd (p, v); }
+        static Vec set (double v) noexcept                        { return _mm_set1_pd (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return _mm_add_pd (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return _mm_sub_pd (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return _mm_mul_pd (a, b); }
+        static Vec div (Vec a, Vec b) noexcept                    { return _mm_div_pd (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return _mm_add_pd (_mm_mul_pd (a, b), c); }
+        static Vec abs (Vec a) noexcept                           { return _mm_andnot_pd (_mm_set1_pd (-0.0), a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return _mm_cmpgt_pd (a, b); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return _mm_or_pd (_mm_and_pd (m, a), _mm_andnot_pd (m, b)); }
+        static Vec min (Vec a, Vec b) noexcept                    { return _mm_min_pd (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return _mm_max_pd (a, b); }
+
+        static Vec floor (Vec a) noexcept
+        {
+            const auto t = _mm_cvtepi32_pd (_mm_cvttpd_epi32 (a));
+            return _mm_sub_pd (t, _mm_and_pd (_mm_cmpgt_pd (t, a), _mm_set1_pd (1.0)));
+        }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            const auto signBit = _mm_set1_pd (-0.0);
+            return _mm_or_pd (_mm_andnot_pd (signBit, mag), _mm_and_pd (signBit, sign));
+        }
+    };
+   #endif
+
+   #if JULESAMP_AVX2
+    struct AVX2FloatOps
+    {
+        using Sample = float;
+        using Vec    = __m256;
+        using Mask   = __m256;
+        static constexpr int width = 8;
+
+        static Vec load (const float* p) noexcept                 { return _mm256_loadu_ps (p); }
+        static void store (float* p, Vec v) noexcept              { _mm256_storeu_ps (p, v); }
+        static Vec set (float v) noexcept                         { return _mm256_set1_ps (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return _mm256_add_ps (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return _mm256_sub_ps (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return _mm256_mul_ps (a, b); }
+        static Vec div (Vec a, Vec b) noexcept                    { return _mm256_div_ps (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return _mm256_fmadd_ps (a, b, c); }
+        static Vec abs (Vec a) noexcept                           { return _mm256_andnot_ps (_mm256_set1_ps (-0.0f), a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return _mm256_cmp_ps (a, b, _CMP_GT_OQ); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return _mm256_blendv_ps (b, a, m); }
+        static Vec min (Vec a, Vec b) noexcept                    { return _mm256_min_ps (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return _mm256_max_ps (a, b); }
+        static Vec floor (Vec a) noexcept                         { return _mm256_floor_ps (a); }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            const auto signBit = _mm256_set1_ps (-0.0f);
+            return _mm256_or_ps (_mm256_andnot_ps (signBit, mag), _mm256_and_ps (signBit, sign));
+        }
+    };
+
+    struct AVX2DoubleOps
+    {
+        using Sample = double;
+        using Vec    = __m256d;
+        using Mask   = __m256d;
+        static constexpr int width = 4;
+
+        static Vec load (const double* p) noexcept                { return _mm256_loadu_pd (p); }
+        static void store (double* p, Vec v) noexcept             { _mm256_storeu_pd (p, v); }
+        static Vec set (double v) noexcept                        { return _mm256_set1_pd (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return _mm256_add_pd (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return _mm256_sub_pd (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return _mm256_mul_pd (a, b); }
+        static Vec div (Vec a, Vec b) noexcept                    { return _mm256_div_pd (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return _mm256_fmadd_pd (a, b, c); }
+        static Vec abs (Vec a) noexcept                           { return _mm256_andnot_pd (_mm256_set1_pd (-0.0), a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return _mm256_cmp_pd (a, b, _CMP_GT_OQ); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return _mm256_blendv_pd (b, a, m); }
+        static Vec min (Vec a, Vec b) noexcept                    { return _mm256_min_pd (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return _mm256_max_pd (a, b); }
+        static Vec floor (Vec a) noexcept                         { return _mm256_floor_pd (a); }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            const auto signBit = _mm256_set1_pd (-0.0);
+            return _mm256_or_pd (_mm256_andnot_pd (signBit, mag), _mm256_and_pd (signBit, sign));
+        }
+    };
+   #endif
+
+   #if JULESAMP_NEON
+    struct NEONFloatOps
+    {
+        using Sample = float;
+        using Vec    = float32x4_t;
+        using Mask   = uint32x4_t;
+        static constexpr int width = 4;
+
+        static Vec load (const float* p) noexcept                 { return vld1q_f32 (p); }
+        static void store (float* p, Vec v) noexcept              { vst1q_f32 (p, v); }
+        static Vec set (float v) noexcept                         { return vdupq_n_f32 (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return vaddq_f32 (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return vsubq_f32 (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return vmulq_f32 (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return vmlaq_f32 (c, a, b); }
+        static Vec abs (Vec a) noexcept                           { return vabsq_f32 (a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return vcgtq_f32 (a, b); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return vbslq_f32 (m, a, b); }
+        static Vec min (Vec a, Vec b) noexcept                    { return vminq_f32 (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return vmaxq_f32 (a, b); }
+
+        static Vec floor (Vec a) noexcept
+        {
+           #if JULESAMP_NEON64
+            return vrndmq_f32 (a);
+           #else
+            const auto t = vcvtq_f32_s32 (vcvtq_s32_f32 (a));
+            return vsubq_f32 (t, vreinterpretq_f32_u32 (vandq_u32 (vcgtq_f32 (t, a), vreinterpretq_u32_f32 (vdupq_n_f32 (1.0f)))));
+           #endif
+        }
+
+        static Vec div (Vec a, Vec b) noexcept
+        {
+           #if JULESAMP_NEON64
+            return vdivq_f32 (a, b);
+           #else
+            auto r = vrecpeq_f32 (b);
+            r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+            r = vmulq_f32 (vrecpsq_f32 (b, r), r);
+            return vmulq_f32 (a, r);
+           #endif
+        }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            return vbslq_f32 (vdupq_n_u32 (0x80000000u), sign, mag);
+        }
+    };
+
+   #if JULESAMP_NEON64
+    struct NEONDoubleOps
+    {
+        using Sample = double;
+        using Vec    = float64x2_t;
+        using Mask   = uint64x2_t;
+        static constexpr int width = 2;
+
+        static Vec load (const double* p) noexcept                { return vld1q_f64 (p); }
+        static void store (double* p, Vec v) noexcept             { vst1q_f64 (p, v); }
+        static Vec set (double v) noexcept                        { return vdupq_n_f64 (v); }
+        static Vec add (Vec a, Vec b) noexcept                    { return vaddq_f64 (a, b); }
+        static Vec sub (Vec a, Vec b) noexcept                    { return vsubq_f64 (a, b); }
+        static Vec mul (Vec a, Vec b) noexcept                    { return vmulq_f64 (a, b); }
+        static Vec div (Vec a, Vec b) noexcept                    { return vdivq_f64 (a, b); }
+        static Vec mulAdd (Vec a, Vec b, Vec c) noexcept          { return vfmaq_f64 (c, a, b); }
+        static Vec abs (Vec a) noexcept                           { return vabsq_f64 (a); }
+        static Mask greaterThan (Vec a, Vec b) noexcept           { return vcgtq_f64 (a, b); }
+        static Vec select (Mask m, Vec a, Vec b) noexcept         { return vbslq_f64 (m, a, b); }
+        static Vec min (Vec a, Vec b) noexcept                    { return vminq_f64 (a, b); }
+        static Vec max (Vec a, Vec b) noexcept                    { return vmaxq_f64 (a, b); }
+        static Vec floor (Vec a) noexcept                         { return vrndmq_f64 (a); }
+
+        static Vec copySign (Vec mag, Vec sign) noexcept
+        {
+            return vbslq_f64 (vdupq_n_u64 (0x8000000000000000ull), sign, mag);
+        }
+    };
+   #endif
+   #endif
+
+    //==============================================================================
+    template <typename Ops>
+    inline typename Ops::Vec atan (typename Ops::Vec x) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        const auto one = Ops::set ((Sample) 1);
+        const auto ax = Ops::abs (x);
+        const auto folded = Ops::greaterThan (ax, one);
+        const auto z = Ops::select (folded, Ops::div (one, ax), ax);
+        const auto z2 = Ops::mul (z, z);
+
+        auto p = Ops::set ((Sample) atanC16);
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC14));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC12));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC10));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC8));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC6));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC4));
+        p = Ops::mulAdd (p, z2, Ops::set ((Sample) atanC2));
+        p = Ops::mulAdd (p, z2, one);
+        p = Ops::mul (p, z);
+
+        return Ops::copySign (Ops::select (folded, Ops::sub (Ops::set ((Sample) halfPi), p), p), x);
+    }
+
+    //==============================================================================
+    // Transfer curves. Each maps the driven sample to roughly [-1, 1] and is a
+    // type rather than a runtime value, so the loops below get one fully
+    // inlined instantiation per curve. outputScale folds the curve's own
+    // normalisation into the wet gain, and reference() is the exact curve
+    // the vector code is checked against.
+
+    struct AtanCurve
+    {
+        static constexpr double outputScale = 2.0 / pi;
+        static double reference (double x) noexcept                   { return std::atan (x); }
+
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept  { return atan<Ops> (x); }
+    };
+
+    struct TanhCurve
+    {
+        static constexpr double outputScale = 1.0;
+        static double reference (double x) noexcept                   { return std::tanh (x); }
+
+        // Lambert's continued fraction cut at [7/6], clamped where it reaches
+        // 1. Within 1e-4 of tanh everywhere, the error peaking near the clamp.
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept
+        {
+            using Sample = typename Ops::Sample;
+
+            const auto limit = Ops::set ((Sample) 4.97);
+            x = Ops::max (Ops::min (x, limit), Ops::sub (Ops::set ((Sample) 0), limit));
+
+            const auto x2 = Ops::mul (x, x);
+            auto num = Ops::mulAdd (x2, Ops::set ((Sample) 1), Ops::set ((Sample) 378));
+            num = Ops::mulAdd (num, x2, Ops::set ((Sample) 17325));
+            num = Ops::mulAdd (num, x2, Ops::set ((Sample) 135135));
+            auto den = Ops::mulAdd (x2, Ops::set ((Sample) 28), Ops::set ((Sample) 3150));
+            den = Ops::mulAdd (den, x2, Ops::set ((Sample) 62370));
+            den = Ops::mulAdd (den, x2, Ops::set ((Sample) 135135));
+
+            const auto one = Ops::set ((Sample) 1);
+            return Ops::max (Ops::min (Ops::div (Ops::mul (x, num), den), one), Ops::sub (Ops::set ((Sample) 0), one));
+        }
+    };
+
+    struct HardClipCurve
+    {
+        static constexpr double outputScale = 1.0;
+        static double reference (double x) noexcept                   { return x < -1.0 ? -1.0 : (x > 1.0 ? 1.0 : x); }
+
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept
+        {
+            using Sample = typename Ops::Sample;
+            return Ops::max (Ops::min (x, Ops::set ((Sample) 1)), Ops::set ((Sample) -1));
+        }
+    };
+
+    /** x / (1 + k|x|): soft towards +1, and with k = 2.5 on the negative side
+        it flattens out at -0.4, the lopsided clipping of a single diode.
+    */
+    struct DiodeCurve
+    {
+        static constexpr double outputScale = 1.0;
+        static constexpr double negativeKnee = 2.5;
+        static double reference (double x) noexcept                   { return x / (1.0 + (x < 0 ? negativeKnee : 1.0) * std::abs (x)); }
+
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept
+        {
+            using Sample = typename Ops::Sample;
+
+            const auto zero = Ops::set ((Sample) 0);
+            const auto knee = Ops::select (Ops::greaterThan (zero, x), Ops::set ((Sample) negativeKnee), Ops::set ((Sample) 1));
+            return Ops::div (x, Ops::mulAdd (knee, Ops::abs (x), Ops::set ((Sample) 1)));
+        }
+    };
+
+    /** Reflects everything past +-1 back into range, a triangle wave in x. */
+    struct FoldbackCurve
+    {
+        static constexpr double outputScale = 1.0;
+
+        static double reference (double x) noexcept
+        {
+            auto t = x - 4.0 * std::floor ((x + 1.0) * 0.25);
+            return t > 1.0 ? 2.0 - t : t;
+        }
+
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept
+        {
+            using Sample = typename Ops::Sample;
+
+            const auto one = Ops::set ((Sample) 1);
+            const auto period = Ops::floor (Ops::mul (Ops::add (x, one), Ops::set ((Sample) 0.25)));
+            const auto t = Ops::sub (x, Ops::mul (period, Ops::set ((Sample) 4)));
+            return Ops::select (Ops::greaterThan (t, one), Ops::sub (Ops::set ((Sample) 2), t), t);
+        }
+    };
+
+    /** 1.5x - 0.5x^3 inside +-1, flat outside. */
+    struct CubicCurve
+    {
+        static constexpr double outputScale = 1.0;
+
+        static double reference (double x) noexcept
+        {
+            x = HardClipCurve::reference (x);
+            return 1.5 * x - 0.5 * x * x * x;
+        }
+
+        template <typename Ops>
+        static typename Ops::Vec apply (typename Ops::Vec x) noexcept
+        {
+            using Sample = typename Ops::Sample;
+
+            x = HardClipCurve::apply<Ops> (x);
+            const auto x2 = Ops::mul (x, x);
+            return Ops::mul (x, Ops::mulAdd (x2, Ops::set ((Sample) -0.5), Ops::set ((Sample) 1.5)));
+        }
+    };
+
+    /** Index order of the curves, matching the "curve" parameter. */
+    enum CurveIndex { atanCurve, tanhCurve, hardClipCurve, diodeCurve, foldbackCurve, cubicCurve, numCurves };
+
+    /** Calls factory.make<Curve>() for the curve at this index, so callers can
+        build a function pointer per curve without a switch in the loop.
+    */
+    template <typename Factory>
+    inline auto forCurve (int curve, const Factory& factory) -> decltype (factory.template make<AtanCurve>())
+    {
+        switch (curve)
+        {
+            case tanhCurve:     return factory.template make<TanhCurve>();
+            case hardClipCurve: return factory.template make<HardClipCurve>();
+            case diodeCurve:    return factory.template make<DiodeCurve>();
+            case foldbackCurve: return factory.template make<FoldbackCurve>();
+            case cubicCurve:    return factory.template make<CubicCurve>();
+            default:            return factory.template make<AtanCurve>();
+        }
+    }
+
+    //==============================================================================
+    /** Shapes every channel of a block in place:
+        (curve (x * gain) * blend + x * (1 - blend)) / 2 * volume
+    */
+    template <typename Ops, typename Curve>
+    inline void shape (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                       typename Ops::Sample gain, typename Ops::Sample blend, typename Ops::Sample volume) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        const auto wetGain = blend * volume * (Sample) (0.5 * Curve::outputScale);
+        const auto dryGain = ((Sample) 1 - blend) * volume * (Sample) 0.5;
+
+        const auto g = Ops::set (gain);
+        const auto wet = Ops::set (wetGain);
+        const auto dry = Ops::set (dryGain);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = channels[channel];
+            int i = 0;
+
+            for (; i + Ops::width <= numSamples; i += Ops::width)
+            {
+                const auto x = Ops::load (data + i);
+                const auto shaped = Curve::template apply<Ops> (Ops::mul (x, g));
+                Ops::store (data + i, Ops::mulAdd (shaped, wet, Ops::mul (x, dry)));
+            }
+
+            if (i < numSamples)
+            {
+                Sample tail[Ops::width] = {};
+
+                for (int j = 0; i + j < numSamples; ++j)
+                    tail[j] = data[i + j];
+
+                const auto x = Ops::load (tail);
+                const auto shaped = Curve::template apply<Ops> (Ops::mul (x, g));
+                Ops::store (tail, Ops::mulAdd (shaped, wet, Ops::mul (x, dry)));
+
+                for (int j = 0; i + j < numSamples; ++j)
+                    data[i + j] = tail[j];
+            }
+        }
+    }
+
+    /** Same curve with per-sample gain, blend and volume taken from smoother ramps.
+        Each vector of ramp values is turned into gain/wet/dry once and applied
+        to every channel, so the parameter math is shared by the whole bus.
+    */
+    template <typename Ops, typename Curve>
+    inline void shapeRamped (typename Ops::Sample* const* channels, int numChannels, int numSamples,
+                             const typename Ops::Sample* gain, const typename Ops::Sample* blend,
+                             const typename Ops::Sample* volume) noexcept
+    {
+        using Sample = typename Ops::Sample;
+
+        const auto one = Ops::set ((Sample) 1);
+        const auto half = Ops::set ((Sample) 0.5);
+        const auto wetScale = Ops::set ((Sample) (0.5 * Curve::outputScale));
+
+        int i = 0;
+
+        for (; i + Ops::width <= numSamples; i += Ops::width)
+        {
+            const auto g = Ops::load (gain + i);
+            const auto b = Ops::load (blend + i);
+            const auto v = Ops::load (volume + i);
+            const auto wet = Ops::mul (Ops::mul (b, v), wetScale);
+            const auto dry = Ops::mul (Ops::mul (Ops::sub (one, b), v), half);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = channels[channel] + i;
+                const auto x = Ops::load (data);
+                const auto shaped = Curve::template apply<Ops> (Ops::mul (x, g));
+                Ops::store (data, Ops::mulAdd (shaped, wet, Ops::mul (x, dry)));
+            }
+        }
+
+        if (i == numSamples)
+            return;
+
+        // The last few samples, zero-padded to a full vector
+        Sample g[Ops::width] = {}, b[Ops::width] = {}, v[Ops::width] = {}, tail[Ops::width] = {};
+        const auto numLeft = numSamples - i;
+
+        for (int j = 0; j < numLeft; ++j)
+        {
+            g[j] = gain[i + j];
+            b[j] = blend[i + j];
+            v[j] = volume[i + j];
+        }
+
+        const auto wet = Ops::mul (Ops::mul (Ops::load (b), Ops::load (v)), wetScale);
+        const auto dry = Ops::mul (Ops::mul (Ops::sub (one, Ops::load (b)), Ops::load (v)), half);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = channels[channel] + i;
+
+            for (int j = 0; j < numLeft; ++j)
+                tail[j] = data[j];
+
+            const auto x = Ops::load (tail);
+            const auto shaped = Curve::template apply<Ops> (Ops::mul (x, Ops::load (g)));
+            Ops::store (tail, Ops::mulAdd (shaped, wet, Ops::mul (x, dry)));
+
+            for (int j = 0; j < numLeft; ++j)
+                data[j] = tail[j];
+        }
+    }
+}
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.cpp
+    Created: 17 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "WorkStealingPool.h"
+
+class WorkStealingPool::Worker  : public juce::Thread
+{
+public:
+    Worker (WorkStealingPool& p, int index)
+        : juce::Thread ("JulesAmp render " + juce::String (index + 1)),
+          pool (p), queueIndex (index)
+    {
+    }
+
+    void run() override
+    {
+        // Woken once per batch; a late wake-up just finds the deques empty
+        while (! threadShouldExit())
+        {
+            wait (-1);
+
+            if (! threadShouldExit())
+                pool.work (queueIndex);
+        }
+    }
+
+private:
+    WorkStealingPool& pool;
+    const int queueIndex;
+};
+
+//==============================================================================
+WorkStealingPool::WorkStealingPool (int numThreads)
+    : numQueues (juce::jmax (1, numThreads))
+{
+    queues.reset (new Queue[(size_t) numQueues]);
+
+    for (int i = 0; i < numQueues - 1; ++i)
+        workers.add (new Worker (*this, i))->startThread();
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    for (auto* worker : workers)
+        worker->stopThread (1000);
+}
+
+//==============================================================================
+void WorkStealingPool::runBatch (int numTasks, Invoker newInvoker, void* newContext)
+{
+    jassert (numTasks <= maxTasks);
+    numTasks = juce::jmin (numTasks, (int) maxTasks);
+
+    if (numTasks <= 0)
+        return;
+
+    invoker = newInvoker;
+    context = newContext;
+    remaining.store (numTasks, std::memory_order_relaxed);
+
+    for (int q = 0; q < numQueues; ++q)
+    {
+        auto& queue = queues[(size_t) q];
+        const juce::SpinLock::ScopedLockType sl (queue.lock);
+        queue.head = queue.tail = 0;
+
+        for (int task = q; task < numTasks; task += numQueues)
+            queue.tasks[queue.tail++] = task;
+    }
+
+    for (auto* worker : workers)
+        worker->notify();
+
+    // The caller's deque is the last one
+    work (numQueues - 1);
+    finished.wait (-1);
+}
+
+void WorkStealingPool::work (int queueIndex)
+{
+    int task = 0;
+
+    while (take (queueIndex, task))
+    {
+        invoker (context, task);
+
+        // Whoever finishes the last task of the batch releases the caller
+        if (remaining.fetch_sub (1, std::memory_order_acq_rel) == 1)
+            finished.signal();
+    }
+}
+
+bool WorkStealingPool::take (int queueIndex, int& task)
+{
+    {
+        auto& own = queues[(size_t) queueIndex];
+        const juce::SpinLock::ScopedLockType sl (own.lock);
+
+        if (own.head < own.tail)
+        {
+            task = own.tasks[own.head++];
+            return true;
+        }
+    }
+
+    for (int i = 1; i < numQueues; ++i)
+    {
+        auto& victim = queues[(size_t) ((queueIndex + i) % numQueues)];
+        const juce::SpinLock::ScopedLockType sl (victim.lock);
+
+        if (victim.head < victim.tail)
+        {
+            task = victim.tasks[--victim.tail];
+            return true;
+        }
+    }
+
+    return false;
+}
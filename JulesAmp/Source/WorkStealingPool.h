@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    WorkStealingPool.h
+    Created: 17 Oct 2026
+
+    Small fork/join pool for offline rendering. run() deals a batch of tasks
+    round-robin into one deque per thread, the calling thread included. Each
+    thread works through its own deque from the front, then steals from the
+    back of the others, so a worker that's slow to wake or a task that runs
+    long doesn't hold the batch up.
+
+    Not for real-time use: waking the workers and waiting on them is fine for
+    a bounce, but has no place in an audio callback.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class WorkStealingPool
+{
+public:
+    /** Largest batch a single run() takes. */
+    static constexpr int maxTasks = 64;
+
+    /** Starts numThreads - 1 workers; the thread calling run() is the last one. */
+    explicit WorkStealingPool (int numThreads);
+    ~WorkStealingPool();
+
+    int getNumThreads() const noexcept      { return workers.size() + 1; }
+
+    /** Calls task (index) once for every index below numTasks, spread over the
+        pool, and returns once they've all finished. One caller at a time,
+        doesn't allocate.
+    */
+    template <typename Task>
+    void run (int numTasks, Task& task)
+    {
+        runBatch (numTasks, [] (void* context, int index) { (*static_cast<Task*> (context)) (index); }, &task);
+    }
+
+private:
+    using Invoker = void (*) (void* context, int index);
+
+    class Worker;
+
+    struct Queue
+    {
+        juce::SpinLock lock;
+        int tasks[maxTasks];
+        int head = 0, tail = 0;     // the owner takes from head, thieves from tail
+    };
+
+    void runBatch (int numTasks, Invoker, void* context);
+    void work (int queueIndex);
+    bool take (int queueIndex, int& task);
+
+    juce::OwnedArray<Worker> workers;
+    std::unique_ptr<Queue[]> queues;
+    int numQueues = 0;
+
+    // Set before a batch is dealt; the queue locks publish them to the workers
+    Invoker invoker = nullptr;
+    void* context = nullptr;
+
+    std::atomic<int> remaining { 0 };
+    juce::WaitableEvent finished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkStealingPool)
+};
@@ -0,0 +1,977 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026
+
+    Headless render and benchmark tool for the JulesAmp DSP core. Streams a
+    WAV/raw float file (or a generated test signal) through
+    JulesAmpAudioProcessor::processBlock in a configurable block size and
+    channel count, and reports throughput and per-callback latency. Every
+    comma separated option is swept, so one run can cover a grid of settings.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../JulesAmp/Source/PluginProcessor.h"
+#include "../../JulesAmp/Source/PluginEditor.h"
+
+#if JUCE_LINUX
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    const char* usage =
+        "Usage: JulesAmpRender [options]\n"
+        "\n"
+        "  --input=<file>          WAV/AIFF/FLAC file, or .raw/.f32 interleaved float32\n"
+        "  --rate=<hz>             sample rate for raw or generated input (default 48000)\n"
+        "  --seconds=<n>           length of the generated test signal (default 10)\n"
+        "  --silence=<n>           seconds of digital silence appended to the input (default 0)\n"
+        "  --output=<file>         write the first configuration's render (.wav or .raw)\n"
+        "  --channels=<n,...>      channel counts to render (default 2)\n"
+        "  --instance-channels=<n,...>  split the bus over instances of n channels, 0 = one instance (default 0)\n"
+        "  --block=<n,...>         host block sizes (default 512)\n"
+        "  --precision=<p,...>     float and/or double (default float)\n"
+        "  --set=<id:v,...>        fixed parameter values, e.g. drive:0.8,quality:2\n"
+        "  --sweep=<id:v|v,...>    swept parameter values, e.g. quality:0|1|2|3,drive:0.2|1\n"
+        "  --ir=<file>             load a cabinet impulse response into every instance\n"
+        "  --sidechain=<n>         enable an n channel sidechain bus fed with a kick pulse (default 0)\n"
+        "  --offline               render with isNonRealtime() set\n"
+        "  --threads=<n,...>       offline render threads per instance, 0 = every core (implies --offline)\n"
+        "  --repeat=<n>            renders per configuration, the fastest is reported (default 1)\n"
+        "  --restore=<n>           instead of rendering, time restoring state into n instances\n"
+        "  --footprint=<n>         instead of rendering, load n instances and report memory and threads\n"
+        "  --kernels               instead of rendering, time every curve's shaping kernel, exits 1 if one\n"
+        "                          costs over 1.5x atan\n"
+        "  --repaint=<n>           instead of rendering, time painting n editors offscreen\n";
+
+    struct Stats
+    {
+        double seconds = 0;
+        juce::int64 frames = 0;
+        int numChannels = 0;
+        std::vector<double> callbackSeconds;
+        int numOverruns = -1;   // from the processor's own profiler, -1 when compiled out
+        int numSkippedBlocks = 0;
+        int numThreads = 1;     // offline threads the first instance rendered with
+    };
+
+    struct Configuration
+    {
+        juce::String precision;
+        int numChannels = 2;
+        int instanceChannels = 0;   // channels per processor instance, 0 = the whole bus
+        int blockSize = 512;
+        juce::StringPairArray parameters;
+        juce::File impulseResponse;
+        int sidechainChannels = 0;
+        int threads = -1;           // offline thread cap per instance, -1 leaves the processor's default
+
+        int getChannelsPerInstance() const
+        {
+            return instanceChannels > 0 ? juce::jmin (instanceChannels, numChannels) : numChannels;
+        }
+
+        int getNumInstances() const
+        {
+            return (numChannels + getChannelsPerInstance() - 1) / getChannelsPerInstance();
+        }
+
+        juce::String describe (bool withThreads = true) const
+        {
+            juce::String s;
+            s << "precision=" << precision << " channels=" << numChannels;
+
+            if (getNumInstances() > 1)
+                s << " instances=" << getNumInstances() << "x" << getChannelsPerInstance();
+
+            s << " block=" << blockSize;
+
+            for (auto& key : parameters.getAllKeys())
+                s << " " << key << "=" << parameters[key];
+
+            if (impulseResponse != juce::File())
+                s << " ir=" << impulseResponse.getFileName();
+
+            if (sidechainChannels > 0)
+                s << " sidechain=" << sidechainChannels;
+
+            if (withThreads && threads >= 0)
+                s << " threads=" << threads;
+
+            return s;
+        }
+    };
+
+    //==============================================================================
+    juce::StringArray splitList (const juce::String& text, const juce::String& separator)
+    {
+        auto items = juce::StringArray::fromTokens (text, separator, {});
+        items.trim();
+        items.removeEmptyStrings();
+        return items;
+    }
+
+    juce::StringArray getListOption (const juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+    {
+        auto items = splitList (args.containsOption (option) ? args.getValueForOption (option) : fallback, ",");
+        return items.isEmpty() ? splitList (fallback, ",") : items;
+    }
+
+    /** Parses "id:value,..." into pairs; swept values are separated with '|'. */
+    juce::StringPairArray parsePairs (const juce::String& text)
+    {
+        juce::StringPairArray pairs;
+
+        for (auto& item : splitList (text, ","))
+            pairs.set (item.upToFirstOccurrenceOf (":", false, false).trim(),
+                       item.fromFirstOccurrenceOf (":", false, false).trim());
+
+        return pairs;
+    }
+
+    //==============================================================================
+    /** A 120 bpm kick: decaying 55 Hz bursts, for keying the sidechain. */
+    void generateKickPulse (juce::AudioBuffer<float>& buffer, int numChannels, int numSamples, double sampleRate)
+    {
+        buffer.setSize (numChannels, numSamples);
+
+        if (numChannels == 0)
+            return;
+
+        const auto period = (int) (sampleRate * 0.5);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto t = (i % period) / sampleRate;
+            auto value = (float) (std::sin (juce::MathConstants<double>::twoPi * 55.0 * t) * std::exp (-t / 0.06));
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.setSample (channel, i, value);
+        }
+    }
+
+    void generateTestSignal (juce::AudioBuffer<float>& buffer, int numChannels, double sampleRate, double seconds)
+    {
+        // A saw with a slow level swell and a little noise, so the shaper sees
+        // both quiet and driven passages. Seeded, so runs are comparable.
+        buffer.setSize (numChannels, (int) (sampleRate * seconds));
+        juce::Random random (42);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+            auto frequency = 110.0 * (1.0 + 0.01 * channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                auto t = i / sampleRate;
+                auto saw = 2.0 * (t * frequency - std::floor (t * frequency + 0.5));
+                auto swell = 0.25 + 0.25 * std::sin (juce::MathConstants<double>::twoPi * 0.2 * t);
+                data[i] = (float) (saw * swell + 0.01 * (random.nextDouble() * 2.0 - 1.0));
+            }
+        }
+    }
+
+    bool loadInput (const juce::File& file, juce::AudioBuffer<float>& buffer, double& sampleRate, int numRawChannels)
+    {
+        if (file.hasFileExtension ("raw;f32"))
+        {
+            juce::MemoryBlock data;
+
+            if (! file.loadFileAsData (data))
+                return false;
+
+            auto* samples = static_cast<const float*> (data.getData());
+            auto numFrames = (int) (data.getSize() / (sizeof (float) * (size_t) numRawChannels));
+            buffer.setSize (numRawChannels, numFrames);
+
+            for (int i = 0; i < numFrames; ++i)
+                for (int channel = 0; channel < numRawChannels; ++channel)
+                    buffer.setSample (channel, i, samples[i * numRawChannels + channel]);
+
+            return true;
+        }
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+
+        if (reader == nullptr)
+            return false;
+
+        sampleRate = reader->sampleRate;
+        buffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return true;
+    }
+
+    /** Spreads the source channels over numChannels by wrapping around. */
+    void matchChannels (const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest, int numChannels)
+    {
+        dest.setSize (numChannels, source.getNumSamples());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            dest.copyFrom (channel, 0, source, channel % source.getNumChannels(), 0, source.getNumSamples());
+    }
+
+    bool writeOutput (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+
+        if (file.hasFileExtension ("raw;f32"))
+        {
+            juce::FileOutputStream out (file);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    out.writeFloat (buffer.getSample (channel, i));
+
+            return out.getStatus().wasOk();
+        }
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (new juce::FileOutputStream (file), sampleRate,
+                                                                              (unsigned int) buffer.getNumChannels(), 32, {}, 0));
+
+        return writer != nullptr && writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    //==============================================================================
+    bool setParameter (JulesAmpAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.getState().getParameter (id))
+        {
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Streams the input through the instances side by side, the way a host
+        would run one processor per slice of the bus. A callback's time is the
+        sum over the instances.
+    */
+    template <typename SampleType>
+    Stats render (juce::OwnedArray<JulesAmpAudioProcessor>& processors, const juce::AudioBuffer<float>& input,
+                  const juce::AudioBuffer<float>& key, int blockSize, juce::AudioBuffer<float>* output)
+    {
+        const auto numChannels = input.getNumChannels();
+        const auto numSamples = input.getNumSamples();
+
+        Stats stats;
+        stats.numChannels = numChannels;
+        stats.callbackSeconds.reserve ((size_t) (numSamples / blockSize + 1));
+
+        juce::AudioBuffer<SampleType> block (numChannels, blockSize);
+        juce::AudioBuffer<SampleType> keyBlock (juce::jmax (1, key.getNumChannels()), blockSize);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const auto n = juce::jmin (blockSize, numSamples - start);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < n; ++i)
+                    block.setSample (channel, i, (SampleType) input.getSample (channel, start + i));
+
+            for (int channel = 0; channel < key.getNumChannels(); ++channel)
+                for (int i = 0; i < n; ++i)
+                    keyBlock.setSample (channel, i, (SampleType) key.getSample (channel, start + i));
+
+            double elapsed = 0;
+            int firstChannel = 0;
+
+            for (auto* processor : processors)
+            {
+                const auto instanceChannels = processor->getMainBusNumInputChannels();
+                const auto sidechainChannels = processor->getChannelCountOfBus (true, 1);
+
+                // Refers to block's channels, so the host buffer size can shrink
+                // without allocating. The sidechain follows the main bus, the
+                // way a host lays the buses out in one buffer.
+                SampleType* channels[DistortionEngine<float>::maxNumChannels + 2] = {};
+
+                for (int channel = 0; channel < instanceChannels; ++channel)
+                    channels[channel] = block.getWritePointer (firstChannel + channel);
+
+                for (int channel = 0; channel < sidechainChannels; ++channel)
+                    channels[instanceChannels + channel] = keyBlock.getWritePointer (channel);
+
+                juce::AudioBuffer<SampleType> hostBuffer (channels, instanceChannels + sidechainChannels, n);
+
+                const auto startTicks = juce::Time::getHighResolutionTicks();
+                processor->processBlock (hostBuffer, midi);
+                elapsed += juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+                firstChannel += instanceChannels;
+            }
+
+            stats.callbackSeconds.push_back (elapsed);
+            stats.seconds += elapsed;
+            stats.frames += n;
+
+            if (output != nullptr)
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < n; ++i)
+                        output->setSample (channel, start + i, (float) block.getSample (channel, i));
+        }
+
+        return stats;
+    }
+
+    double percentile (std::vector<double> values, double fraction)
+    {
+        if (values.empty())
+            return 0;
+
+        std::sort (values.begin(), values.end());
+        return values[(size_t) juce::jlimit (0.0, (double) values.size() - 1, std::ceil (fraction * (double) values.size()) - 1)];
+    }
+
+    /** The render a thread count sweep is measured against. */
+    struct Reference
+    {
+        double seconds = 0;
+        juce::AudioBuffer<float> output;
+    };
+
+    bool isIdentical (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            if (std::memcmp (a.getReadPointer (channel), b.getReadPointer (channel), sizeof (float) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+
+    void report (const Configuration& config, const Stats& stats, double sampleRate,
+                 const Reference* reference = nullptr, const juce::AudioBuffer<float>& output = {})
+    {
+        const auto channelSamples = (double) stats.frames * stats.numChannels;
+        const auto audioSeconds = (double) stats.frames / sampleRate;
+
+        juce::String line (config.describe());
+        line << " samples/s=" << juce::String (channelSamples / stats.seconds, 0)
+             << " ns/sample=" << juce::String (stats.seconds * 1.0e9 / channelSamples, 3)
+             << " realtime=" << juce::String (audioSeconds / stats.seconds, 1) << "x"
+             << " p50=" << juce::String (percentile (stats.callbackSeconds, 0.50) * 1.0e6, 2) << "us"
+             << " p99=" << juce::String (percentile (stats.callbackSeconds, 0.99) * 1.0e6, 2) << "us"
+             << " max=" << juce::String (percentile (stats.callbackSeconds, 1.00) * 1.0e6, 2) << "us";
+
+        if (stats.numOverruns >= 0)
+            line << " overruns=" << stats.numOverruns;
+
+        line << " skipped=" << stats.numSkippedBlocks << "/" << (int) stats.callbackSeconds.size() * config.getNumInstances();
+
+        // Offline thread sweeps: threads actually used (capped by the channel
+        // count), and speed and output against the sweep's first thread count
+        if (config.threads >= 0)
+        {
+            line << " active=" << stats.numThreads;
+
+            if (reference != nullptr)
+                line << " speedup=" << juce::String (reference->seconds / stats.seconds, 2) << "x"
+                     << " identical=" << (isIdentical (reference->output, output) ? "yes" : "NO");
+        }
+
+        std::cout << line << std::endl;
+    }
+
+    //==============================================================================
+    /** Expands every swept parameter into its own configuration. */
+    void expandSweeps (juce::Array<Configuration>& configs, const juce::StringPairArray& sweeps)
+    {
+        for (auto& id : sweeps.getAllKeys())
+        {
+            juce::Array<Configuration> expanded;
+
+            for (auto& config : configs)
+            {
+                for (auto& value : splitList (sweeps[id], "|"))
+                {
+                    auto c = config;
+                    c.parameters.set (id, value);
+                    expanded.add (c);
+                }
+            }
+
+            configs.swapWith (expanded);
+        }
+    }
+
+    Stats renderConfiguration (const Configuration& config, const juce::AudioBuffer<float>& source, double sampleRate,
+                               bool offline, juce::AudioBuffer<float>* output)
+    {
+        juce::OwnedArray<JulesAmpAudioProcessor> processors;
+        const bool useDouble = config.precision == "double";
+
+        for (int remaining = config.numChannels; remaining > 0; remaining -= config.getChannelsPerInstance())
+        {
+            auto numChannels = juce::jmin (remaining, config.getChannelsPerInstance());
+            auto* processor = processors.add (new JulesAmpAudioProcessor());
+
+            processor->setProcessingPrecision (useDouble ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+            processor->setPlayConfigDetails (numChannels, numChannels, sampleRate, config.blockSize);
+            processor->setNonRealtime (offline);
+
+            if (config.threads >= 0)
+                processor->setMaximumOfflineThreads (config.threads);
+
+            if (config.sidechainChannels > 0)
+            {
+                auto layout = processor->getBusesLayout();
+
+                if (layout.inputBuses.size() > 1)
+                    layout.inputBuses.getReference (1) = juce::AudioChannelSet::canonicalChannelSet (config.sidechainChannels);
+
+                processor->setBusesLayout (layout);
+            }
+
+            if (processor->getMainBusNumInputChannels() != numChannels
+             || processor->getChannelCountOfBus (true, 1) != config.sidechainChannels)
+            {
+                std::cerr << config.describe() << ": channel layout not supported" << std::endl;
+                return {};
+            }
+
+            for (auto& id : config.parameters.getAllKeys())
+                if (! setParameter (*processor, id, config.parameters[id].getFloatValue()))
+                    std::cerr << "Unknown parameter: " << id << std::endl;
+        }
+
+        juce::AudioBuffer<float> input, key;
+        matchChannels (source, input, config.numChannels);
+        generateKickPulse (key, config.sidechainChannels, input.getNumSamples(), sampleRate);
+
+        if (output != nullptr)
+            output->setSize (config.numChannels, input.getNumSamples());
+
+        for (auto* processor : processors)
+        {
+            processor->prepareToPlay (sampleRate, config.blockSize);
+
+            if (config.impulseResponse != juce::File() && ! processor->loadCabinetImpulseResponse (config.impulseResponse))
+            {
+                std::cerr << "Can't read impulse response: " << config.impulseResponse.getFullPathName() << std::endl;
+                return {};
+            }
+        }
+
+        // Give background work (shaper tables, IR preparation) a moment, so we
+        // measure the steady state
+        juce::Thread::sleep (config.impulseResponse != juce::File() ? 500 : 50);
+
+        auto stats = useDouble ? render<double> (processors, input, key, config.blockSize, output)
+                               : render<float> (processors, input, key, config.blockSize, output);
+
+        stats.numThreads = processors.getFirst()->getNumOfflineThreads();
+
+       #if JULESAMP_ENABLE_PROFILER
+        stats.numOverruns = 0;
+       #endif
+
+        for (auto* processor : processors)
+        {
+            stats.numSkippedBlocks += (int) processor->getNumSkippedBlocks();
+
+           #if JULESAMP_ENABLE_PROFILER
+            stats.numOverruns += (int) processor->getProfiler().getStats().numOverruns;
+           #endif
+
+            processor->releaseResources();
+        }
+
+        return stats;
+    }
+
+    //==============================================================================
+    /** Times setStateInformation over many fresh instances, as a host does when
+        it loads a project, for the current format and for a legacy ValueTree blob.
+    */
+    void benchmarkStateRestore (int numInstances, const juce::StringPairArray& parameters)
+    {
+        juce::MemoryBlock current, legacy;
+
+        {
+            JulesAmpAudioProcessor source;
+
+            for (auto& id : parameters.getAllKeys())
+                setParameter (source, id, parameters[id].getFloatValue());
+
+            source.getStateInformation (current);
+
+            juce::MemoryOutputStream stream (legacy, false);
+            source.getState().copyState().writeToStream (stream);
+        }
+
+        juce::OwnedArray<JulesAmpAudioProcessor> processors;
+
+        for (int i = 0; i < numInstances; ++i)
+            processors.add (new JulesAmpAudioProcessor());
+
+        for (auto* blob : { &current, &legacy })
+        {
+            auto* format = blob == &current ? "binary" : "legacy";
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            for (auto* processor : processors)
+                processor->setStateInformation (blob->getData(), (int) blob->getSize());
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+            std::cout << "restore format=" << format << " instances=" << numInstances
+                      << " bytes=" << (int) blob->getSize()
+                      << " total=" << juce::String (elapsed * 1.0e3, 3) << "ms"
+                      << " per-instance=" << juce::String (elapsed * 1.0e6 / numInstances, 2) << "us" << std::endl;
+        }
+    }
+    //==============================================================================
+    /** Resident memory and thread count of this process, or -1 where the
+        platform has no cheap way to ask.
+    */
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        // statm's second field is the resident page count
+        auto fields = juce::StringArray::fromTokens (juce::File ("/proc/self/statm").loadFileAsString(), true);
+        return fields[1].getLargeIntValue() * (juce::int64) sysconf (_SC_PAGESIZE);
+       #else
+        return -1;
+       #endif
+    }
+
+    int getNumThreads()
+    {
+       #if JUCE_LINUX
+        for (auto& line : juce::StringArray::fromLines (juce::File ("/proc/self/status").loadFileAsString()))
+            if (line.startsWith ("Threads:"))
+                return line.fromFirstOccurrenceOf (":", false, false).trim().getIntValue();
+       #endif
+
+        return -1;
+    }
+
+    /** Loads n instances with the same settings, as a large session does, and
+        reports what they cost in memory, threads and load time, and what the
+        shared resource pool ends up holding for all of them.
+    */
+    void benchmarkFootprint (int numInstances, const juce::StringPairArray& parameters, const juce::File& impulseResponse,
+                             double sampleRate, int blockSize)
+    {
+        const auto bytesBefore = getResidentBytes();
+        const auto threadsBefore = getNumThreads();
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        juce::OwnedArray<JulesAmpAudioProcessor> processors;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto* processor = processors.add (new JulesAmpAudioProcessor());
+
+            for (auto& id : parameters.getAllKeys())
+                if (! setParameter (*processor, id, parameters[id].getFloatValue()))
+                    std::cerr << "Unknown parameter: " << id << std::endl;
+
+            processor->prepareToPlay (sampleRate, blockSize);
+
+            if (impulseResponse != juce::File() && ! processor->loadCabinetImpulseResponse (impulseResponse))
+            {
+                std::cerr << "Can't read impulse response: " << impulseResponse.getFullPathName() << std::endl;
+                return;
+            }
+        }
+
+        const auto loadSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+        // A block each requests the shaper tables, the second one after the
+        // background work has settled picks them up
+        juce::AudioBuffer<float> source, buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        generateTestSignal (source, 2, sampleRate, 1.0 + blockSize / sampleRate);
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (auto* processor : processors)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    buffer.copyFrom (channel, 0, source, channel, 0, blockSize);
+
+                processor->processBlock (buffer, midi);
+            }
+
+            juce::Thread::sleep (impulseResponse != juce::File() ? 500 : 100);
+        }
+
+        const auto bytesAfter = getResidentBytes();
+        const auto threadsAfter = getNumThreads();
+        const auto shared = juce::SharedResourcePointer<SharedResources>()->getStats();
+
+        std::cout << "footprint instances=" << numInstances
+                  << " load=" << juce::String (loadSeconds * 1.0e3, 1) << "ms"
+                  << " per-instance-load=" << juce::String (loadSeconds * 1.0e3 / numInstances, 3) << "ms";
+
+        if (bytesBefore >= 0 && bytesAfter >= 0)
+            std::cout << " rss=+" << juce::String ((bytesAfter - bytesBefore) / 1048576.0, 1) << "MB"
+                      << " per-instance=" << juce::String ((bytesAfter - bytesBefore) / 1024.0 / numInstances, 1) << "KB";
+
+        if (threadsBefore >= 0 && threadsAfter >= 0)
+            std::cout << " threads=+" << (threadsAfter - threadsBefore);
+
+        std::cout << " shared-tables=" << shared.numTables << " (" << (int) (shared.tableBytes / 1024) << "KB)"
+                  << " shared-irs=" << shared.numImpulseResponses << " (" << (int) (shared.impulseResponseBytes / 1024) << "KB)"
+                  << std::endl;
+
+        for (auto* processor : processors)
+            processor->releaseResources();
+    }
+
+    //==============================================================================
+    /** Times each curve's constant-parameter kernel on every implementation this
+        CPU runs. Returns false when a curve costs over Waveshaper::maxCostAgainstAtan
+        times atan, on any implementation but the reference one.
+    */
+    template <typename SampleType>
+    bool benchmarkKernels (const char* precision, int numRepeats)
+    {
+        using Shaper = Waveshaper<SampleType>;
+        using Implementation = typename Shaper::Implementation;
+
+        const char* curveNames[] = { "atan", "tanh", "hardclip", "diode", "foldback", "cubic" };
+        static_assert (juce::numElementsInArray (curveNames) == Shaper::numCurves, "Name every curve");
+
+        constexpr int numChannels = 2, numSamples = 4096;
+        juce::AudioBuffer<SampleType> source (numChannels, numSamples), work (numChannels, numSamples);
+        juce::Random random (1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < numSamples; ++i)
+                source.setSample (channel, i, (SampleType) (random.nextDouble() * 2.0 - 1.0));
+
+        bool withinBound = true;
+
+        for (auto impl : { Implementation::reference, Implementation::scalar, Implementation::sse2,
+                           Implementation::avx2, Implementation::neon })
+        {
+            if (! Shaper::isSupported (impl))
+                continue;
+
+            Shaper shaper;
+            shaper.setImplementation (impl);
+            double nanosPerSample[Shaper::numCurves] = {};
+
+            for (int curve = 0; curve < Shaper::numCurves; ++curve)
+            {
+                shaper.setCurve (curve, 0);
+                auto best = std::numeric_limits<double>::max();
+
+                for (int repeat = 0; repeat < numRepeats; ++repeat)
+                {
+                    work.makeCopyOf (source, true);
+                    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+                    shaper.process (work.getArrayOfWritePointers(), numChannels, numSamples,
+                                    (SampleType) 4, (SampleType) 0.8, (SampleType) 1);
+
+                    best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks));
+                }
+
+                nanosPerSample[curve] = best * 1.0e9 / (numChannels * numSamples);
+            }
+
+            for (int curve = 0; curve < Shaper::numCurves; ++curve)
+            {
+                const auto ratio = nanosPerSample[curve] / nanosPerSample[Shaper::atanCurve];
+                const auto over = ratio > Shaper::maxCostAgainstAtan && impl != Implementation::reference;
+
+                std::cout << "kernel precision=" << precision
+                          << " impl=" << Shaper::getImplementationName (impl)
+                          << " curve=" << curveNames[curve]
+                          << " ns/sample=" << juce::String (nanosPerSample[curve], 3)
+                          << " vs-atan=" << juce::String (ratio, 2)
+                          << (over ? " (over bound)" : "") << std::endl;
+
+                withinBound = withinBound && ! over;
+            }
+        }
+
+        return withinBound;
+    }
+
+    //==============================================================================
+    /** Paints editors into an offscreen image, as a host repaints open plugin
+        windows. The first frame at each window size and display scale rebuilds
+        the cached layers, the rest move every knob and show the steady state.
+    */
+    void benchmarkRepaint (int numEditors, int numFrames)
+    {
+        juce::OwnedArray<JulesAmpAudioProcessor> processors;
+        juce::OwnedArray<juce::AudioProcessorEditor> editors;
+
+        for (int i = 0; i < numEditors; ++i)
+            editors.add (processors.add (new JulesAmpAudioProcessor())->createEditorIfNeeded());
+
+        RotarySliderWithLabels knob (*processors.getFirst()->getState().getParameter ("drive"), "");
+
+        auto moveKnobs = [&] (double phase)
+        {
+            for (auto* editor : editors)
+                for (auto* child : editor->getChildren())
+                    if (auto* slider = dynamic_cast<juce::Slider*> (child))
+                        slider->setValue (slider->getMinimum() + (slider->getMaximum() - slider->getMinimum()) * phase,
+                                          juce::dontSendNotification);
+
+            knob.setValue (knob.getMinimum() + (knob.getMaximum() - knob.getMinimum()) * phase, juce::dontSendNotification);
+        };
+
+        auto seconds = [] (juce::int64 startTicks)
+        {
+            return juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+        };
+
+        // Window size as a multiple of the default, then the display scale;
+        // the last is a 4K-class surface
+        const struct { int size; float scale; } setups[] = { { 1, 1.0f }, { 1, 2.0f }, { 2, 2.0f } };
+
+        for (auto setup : setups)
+        {
+            const auto scale = setup.scale;
+
+            for (auto* editor : editors)
+                editor->setSize (JulesAmpAudioProcessorEditor::defaultWidth * setup.size,
+                                 JulesAmpAudioProcessorEditor::defaultHeight * setup.size);
+
+            knob.setSize (150 * setup.size, 150 * setup.size);
+
+            auto& first = *editors.getFirst();
+            juce::Image canvas (juce::Image::RGB, juce::roundToInt (first.getWidth() * scale), juce::roundToInt (first.getHeight() * scale), false);
+            juce::Image knobCanvas (juce::Image::ARGB, juce::roundToInt (knob.getWidth() * scale), juce::roundToInt (knob.getHeight() * scale), true);
+
+            auto paintFrame = [&]
+            {
+                for (auto* editor : editors)
+                {
+                    juce::Graphics g (canvas);
+                    g.addTransform (juce::AffineTransform::scale (scale));
+                    editor->paintEntireComponent (g, false);
+                }
+            };
+
+            auto paintKnob = [&]
+            {
+                juce::Graphics g (knobCanvas);
+                g.addTransform (juce::AffineTransform::scale (scale));
+                knob.paintEntireComponent (g, false);
+            };
+
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            paintFrame();
+            const auto cold = seconds (startTicks);
+
+            startTicks = juce::Time::getHighResolutionTicks();
+            paintKnob();
+            const auto knobCold = seconds (startTicks);
+
+            double warm = 0, knobWarm = 0;
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                moveKnobs ((frame % 64) / 63.0);
+
+                startTicks = juce::Time::getHighResolutionTicks();
+                paintFrame();
+                warm += seconds (startTicks);
+
+                startTicks = juce::Time::getHighResolutionTicks();
+                paintKnob();
+                knobWarm += seconds (startTicks);
+            }
+
+            warm /= numFrames;
+            knobWarm /= numFrames;
+
+            // Share of the message thread the editors take at the capped frame rate
+            const auto load = warm * JulesAmpAudioProcessorEditor::maxFrameRate;
+
+            std::cout << "repaint window=" << first.getWidth() << "x" << first.getHeight()
+                      << " scale=" << scale << " editors=" << numEditors
+                      << " cold=" << juce::String (cold * 1.0e3, 3) << "ms"
+                      << " frame=" << juce::String (warm * 1.0e3, 3) << "ms"
+                      << " per-editor=" << juce::String (warm * 1.0e6 / numEditors, 1) << "us"
+                      << " knob-cold=" << juce::String (knobCold * 1.0e6, 1) << "us"
+                      << " knob=" << juce::String (knobWarm * 1.0e6, 1) << "us"
+                      << " load@" << JulesAmpAudioProcessorEditor::maxFrameRate << "fps="
+                      << juce::String (load * 100.0, 1) << "%" << std::endl;
+        }
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << usage;
+        return 0;
+    }
+
+    if (args.containsOption ("--restore"))
+    {
+        benchmarkStateRestore (juce::jmax (1, args.getValueForOption ("--restore").getIntValue()),
+                               parsePairs (args.getValueForOption ("--set")));
+        return 0;
+    }
+
+    if (args.containsOption ("--kernels"))
+    {
+        const auto repeats = juce::jmax (1, args.getValueForOption ("--repeat").getIntValue());
+        const auto floatWithinBound = benchmarkKernels<float> ("float", juce::jmax (100, repeats));
+        const auto doubleWithinBound = benchmarkKernels<double> ("double", juce::jmax (100, repeats));
+        return floatWithinBound && doubleWithinBound ? 0 : 1;
+    }
+
+    if (args.containsOption ("--repaint"))
+    {
+        const auto repeats = juce::jmax (1, args.getValueForOption ("--repeat").getIntValue());
+        benchmarkRepaint (juce::jmax (1, args.getValueForOption ("--repaint").getIntValue()), juce::jmax (100, repeats));
+        return 0;
+    }
+
+    auto sampleRate = args.containsOption ("--rate") ? args.getValueForOption ("--rate").getDoubleValue() : 48000.0;
+
+    if (args.containsOption ("--footprint"))
+    {
+        benchmarkFootprint (juce::jmax (1, args.getValueForOption ("--footprint").getIntValue()),
+                            parsePairs (args.getValueForOption ("--set")),
+                            args.containsOption ("--ir") ? args.getFileForOption ("--ir") : juce::File(),
+                            sampleRate, juce::jmax (1, getListOption (args, "--block", "512")[0].getIntValue()));
+        return 0;
+    }
+
+    auto channelCounts = getListOption (args, "--channels", "2");
+
+    juce::AudioBuffer<float> source;
+
+    if (args.containsOption ("--input"))
+    {
+        auto file = args.getFileForOption ("--input");
+
+        if (! loadInput (file, source, sampleRate, channelCounts[0].getIntValue()))
+        {
+            std::cerr << "Couldn't read " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        auto seconds = args.containsOption ("--seconds") ? args.getValueForOption ("--seconds").getDoubleValue() : 10.0;
+        generateTestSignal (source, 2, sampleRate, seconds);
+    }
+
+    if (args.containsOption ("--silence"))
+    {
+        // Exercises the processor's silence detection and tail handling
+        auto numSilent = (int) (args.getValueForOption ("--silence").getDoubleValue() * sampleRate);
+        auto numSamples = source.getNumSamples();
+
+        source.setSize (source.getNumChannels(), numSamples + juce::jmax (0, numSilent), true, true);
+    }
+
+    if (source.getNumSamples() == 0 || source.getNumChannels() == 0)
+    {
+        std::cerr << "Nothing to render" << std::endl;
+        return 1;
+    }
+
+    juce::Array<Configuration> configs;
+    auto fixed = parsePairs (args.getValueForOption ("--set"));
+
+    for (auto& precision : getListOption (args, "--precision", "float"))
+    {
+        for (auto& channels : channelCounts)
+        {
+            for (auto& instanceChannels : getListOption (args, "--instance-channels", "0"))
+            {
+                for (auto& block : getListOption (args, "--block", "512"))
+                {
+                    for (auto& threads : getListOption (args, "--threads", "-1"))
+                    {
+                        Configuration config;
+                        config.precision = precision;
+                        config.numChannels = juce::jmax (1, channels.getIntValue());
+                        config.instanceChannels = juce::jmax (0, instanceChannels.getIntValue());
+                        config.blockSize = juce::jmax (1, block.getIntValue());
+                        config.parameters = fixed;
+
+                        if (args.containsOption ("--ir"))
+                            config.impulseResponse = args.getFileForOption ("--ir");
+
+                        config.sidechainChannels = juce::jlimit (0, 2, args.getValueForOption ("--sidechain").getIntValue());
+                        config.threads = juce::jmax (-1, threads.getIntValue());
+
+                        configs.add (config);
+                    }
+                }
+            }
+        }
+    }
+
+    expandSweeps (configs, parsePairs (args.getValueForOption ("--sweep")));
+
+    const auto offline = args.containsOption ("--offline") || args.containsOption ("--threads");
+    const auto repeats = juce::jmax (1, args.getValueForOption ("--repeat").getIntValue());
+    const auto outputFile = args.containsOption ("--output") ? args.getFileForOption ("--output") : juce::File();
+
+    // With --threads, every configuration's first thread count is the
+    // reference the others are timed and compared against
+    std::map<juce::String, Reference> references;
+
+    for (int i = 0; i < configs.size(); ++i)
+    {
+        const auto& config = configs.getReference (i);
+        juce::AudioBuffer<float> rendered;
+        auto* output = ((i == 0 && outputFile != juce::File()) || config.threads >= 0) ? &rendered : nullptr;
+        Stats best;
+
+        for (int r = 0; r < repeats; ++r)
+        {
+            auto stats = renderConfiguration (config, source, sampleRate, offline, r == 0 ? output : nullptr);
+
+            if (r == 0 || stats.seconds < best.seconds)
+                best = std::move (stats);
+        }
+
+        if (best.frames == 0)
+            continue;
+
+        const Reference* reference = nullptr;
+
+        if (config.threads >= 0)
+        {
+            auto inserted = references.emplace (config.describe (false), Reference { best.seconds, rendered });
+            reference = inserted.second ? nullptr : &inserted.first->second;
+        }
+
+        report (config, best, sampleRate, reference, rendered);
+
+        if (i == 0 && outputFile != juce::File() && ! writeOutput (outputFile, rendered, sampleRate))
+        {
+            std::cerr << "Couldn't write " << outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
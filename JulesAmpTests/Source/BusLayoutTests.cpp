@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    BusLayoutTests.cpp
+    Created: 17 Oct 2026
+
+    Bus layouts a host may offer: the ones isBusesLayoutSupported accepts
+    must also render, the rest must be turned down.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class BusLayoutTests  : public juce::UnitTest
+{
+public:
+    BusLayoutTests()  : juce::UnitTest ("Bus layouts", "JulesAmp Layout") {}
+
+    void runTest() override
+    {
+        using Set = juce::AudioChannelSet;
+        const auto disabled = Set::disabled();
+
+        beginTest ("Matched main buses are accepted and render");
+        {
+            for (auto& set : { Set::mono(), Set::stereo(), Set::createLCR(), Set::quadraphonic(), Set::create5point1(),
+                               Set::create7point1(), Set::create7point1point4(), Set::ambisonic (1), Set::ambisonic (3),
+                               Set::discreteChannels (DistortionEngine<float>::maxNumChannels) })
+                checkLayout (set, set, disabled, true);
+        }
+
+        beginTest ("Mono and stereo sidechains are accepted and render");
+        {
+            checkLayout (Set::stereo(), Set::stereo(), Set::mono(), true);
+            checkLayout (Set::stereo(), Set::stereo(), Set::stereo(), true);
+            checkLayout (Set::create5point1(), Set::create5point1(), Set::stereo(), true);
+        }
+
+        beginTest ("Unsupported layouts are rejected");
+        {
+            checkLayout (Set::stereo(), Set::mono(), disabled, false);
+            checkLayout (Set::mono(), Set::stereo(), disabled, false);
+            checkLayout (Set::create5point1(), Set::create7point1(), disabled, false);
+            checkLayout (Set::stereo(), disabled, disabled, false);
+            checkLayout (Set::stereo(), Set::stereo(), Set::create5point1(), false);
+
+            const auto tooWide = Set::discreteChannels (DistortionEngine<float>::maxNumChannels + 1);
+            checkLayout (tooWide, tooWide, disabled, false);
+        }
+    }
+
+private:
+    /** Offers the layout as a host would. An accepted one is then prepared
+        and fed a driven, ducked signal through every bus, in both precisions.
+    */
+    void checkLayout (const juce::AudioChannelSet& input, const juce::AudioChannelSet& output,
+                      const juce::AudioChannelSet& sidechain, bool shouldBeAccepted)
+    {
+        const auto name = input.getDescription() + " -> " + output.getDescription()
+                        + (sidechain.isDisabled() ? juce::String() : ", sidechain " + sidechain.getDescription());
+
+        for (auto useDouble : { false, true })
+        {
+            JulesAmpAudioProcessor processor;
+            processor.setProcessingPrecision (useDouble ? juce::AudioProcessor::doublePrecision
+                                                        : juce::AudioProcessor::singlePrecision);
+
+            auto layout = processor.getBusesLayout();
+            layout.inputBuses.getReference (0) = input;
+            layout.outputBuses.getReference (0) = output;
+
+            if (layout.inputBuses.size() > 1)
+                layout.inputBuses.getReference (1) = sidechain;
+
+            expect (processor.checkBusesLayoutSupported (layout) == shouldBeAccepted,
+                    name + (shouldBeAccepted ? " was rejected" : " was accepted"));
+
+            if (! shouldBeAccepted)
+                continue;
+
+            expect (processor.setBusesLayout (layout), name + " wasn't applied");
+            expectEquals (processor.getChannelCountOfBus (true, 1), sidechain.size(), name);
+
+            TestHarness::setParameters (processor, "drive:0.8,range:40,quality:1,dynamics:0.5,duck:0.5,key:"
+                                                     + juce::String (sidechain.isDisabled() ? 0 : 1));
+            processor.prepareToPlay (48000.0, 512);
+
+            if (useDouble)
+                checkRender<double> (processor, name);
+            else
+                checkRender<float> (processor, name);
+        }
+    }
+
+    template <typename SampleType>
+    void checkRender (JulesAmpAudioProcessor& processor, const juce::String& name)
+    {
+        const auto numChannels = processor.getMainBusNumOutputChannels();
+
+        juce::AudioBuffer<SampleType> buffer, key;
+        TestHarness::generateTestSignal (buffer, numChannels, 4800, 48000.0);
+        TestHarness::generateTestSignal (key, 2, 4800, 48000.0, 7);
+
+        TestHarness::render (processor, buffer, 512, &key);
+
+        expect (TestHarness::isFinite (buffer), name + " rendered a non-finite sample");
+
+        // Every output channel is processed, not just the first pair
+        for (int channel = 0; channel < numChannels; ++channel)
+            expectGreaterThan ((double) buffer.getMagnitude (channel, 0, buffer.getNumSamples()), 0.0,
+                               name + " left channel " + juce::String (channel) + " silent");
+    }
+};
+
+static BusLayoutTests busLayoutTests;
@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+
+    DspTests.cpp
+    Created: 17 Oct 2026
+
+    Golden-output tests: renders through processBlock are nulled against the
+    shaper formula evaluated with std::atan in double precision, and the paths
+    that promise bit-exact output (dry blend, parallel offline renders) are
+    compared sample for sample.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class DspTests  : public juce::UnitTest
+{
+public:
+    DspTests()  : juce::UnitTest ("Golden output", "JulesAmp DSP") {}
+
+    void runTest() override
+    {
+        beginTest ("Atan curve nulls against the reference formula, float");
+        checkAtanFormula<float>();
+
+        beginTest ("Atan curve nulls against the reference formula, double");
+        checkAtanFormula<double>();
+
+        beginTest ("Fully dry at Volume 2 is the identity");
+        checkDryIdentity();
+
+        beginTest ("Fully dry with oversampling keeps the reported latency");
+        checkDryLatency();
+
+        beginTest ("A stepped automation lane steps on its exact samples, real-time");
+        checkSteppedAutomation (false);
+
+        beginTest ("A stepped automation lane steps on its exact samples, offline");
+        checkSteppedAutomation (true);
+
+        beginTest ("Parallel offline render matches the serial one bit for bit, float");
+        checkParallelRender<float>();
+
+        beginTest ("Parallel offline render matches the serial one bit for bit, double");
+        checkParallelRender<double>();
+
+        beginTest ("Silence is skipped once the tail has rung out");
+        checkSilence();
+
+        beginTest ("A program switch glides to the new settings");
+        checkProgramSwitch();
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    /** (curve (x * drive * range) * blend + x * (1 - blend)) / 2 * volume, with
+        atan normalised to +/-1: what the shaper computed before any of the
+        vector kernels, tables or smoothing went in.
+    */
+    static double referenceShaper (double x, double gain, double blend, double volume)
+    {
+        auto wet = std::atan (x * gain) * 2.0 / juce::MathConstants<double>::pi;
+        return (wet * blend + x * (1.0 - blend)) / 2.0 * volume;
+    }
+
+    template <typename SampleType>
+    void checkAtanFormula()
+    {
+        // Default, gentle, hard and maximum drive, and a mostly dry mix
+        const char* settings[] = { "drive:1,range:1,blend:1,volume:1",
+                                   "drive:0.25,range:12,blend:1,volume:1",
+                                   "drive:1,range:400,blend:0.6,volume:2.5",
+                                   "drive:1,range:1500,blend:1,volume:1",
+                                   "drive:0.5,range:40,blend:0.3,volume:0.5" };
+
+        double worstNull = 0;
+
+        for (auto* parameters : settings)
+        {
+            // A single sample, an odd size that leaves a vector tail, and a typical host block
+            for (auto blockSize : { 1, 37, 512 })
+            {
+                TestHarness::Setup setup;
+                setup.useDouble = std::is_same<SampleType, double>::value;
+                setup.blockSize = blockSize;
+                setup.parameters = juce::String (parameters) + ",ir:0";
+
+                auto processor = TestHarness::createProcessor (setup);
+                expect (processor != nullptr, "Can't set up " + setup.parameters);
+
+                if (processor == nullptr)
+                    continue;
+
+                juce::AudioBuffer<SampleType> input;
+                TestHarness::generateTestSignal (input, setup.numChannels, (int) (sampleRate / 4), sampleRate);
+
+                juce::AudioBuffer<SampleType> output (input);
+                TestHarness::render (*processor, output, blockSize);
+
+                // The snapped values the processor got, not the ones asked for
+                const auto gain = (double) TestHarness::getParameter (*processor, "drive")
+                                * (double) TestHarness::getParameter (*processor, "range");
+                const auto blend = (double) TestHarness::getParameter (*processor, "blend");
+                const auto volume = (double) TestHarness::getParameter (*processor, "volume");
+
+                // The kernels' atan error scaled by the wet gain, plus a few
+                // rounding steps of the sample type at the output's level
+                const auto tolerance = Waveshaper<SampleType>::maxAtanError * blend * volume / juce::MathConstants<double>::pi
+                                     + 8.0 * std::numeric_limits<SampleType>::epsilon() * juce::jmax (1.0, volume);
+
+                double maxError = 0, signalPower = 0, residualPower = 0;
+
+                for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                {
+                    for (int i = 0; i < input.getNumSamples(); ++i)
+                    {
+                        auto expected = referenceShaper ((double) input.getSample (channel, i), gain, blend, volume);
+                        auto error = (double) output.getSample (channel, i) - expected;
+
+                        maxError = juce::jmax (maxError, std::abs (error));
+                        signalPower += expected * expected;
+                        residualPower += error * error;
+                    }
+                }
+
+                expectLessOrEqual (maxError, tolerance,
+                                   setup.parameters + " block=" + juce::String (blockSize)
+                                     + ": max error " + juce::String (maxError, 12));
+
+                if (residualPower > 0)
+                    worstNull = juce::jmax (worstNull, 10.0 * std::log10 (residualPower / signalPower));
+            }
+        }
+
+        logMessage ("Worst null against the reference: " + juce::String (worstNull, 1) + " dB");
+    }
+
+    void checkDryIdentity()
+    {
+        TestHarness::Setup setup;
+        setup.parameters = "drive:1,range:400,blend:0,volume:2,ir:0";
+
+        auto processor = TestHarness::createProcessor (setup);
+        expect (processor != nullptr);
+
+        if (processor == nullptr)
+            return;
+
+        juce::AudioBuffer<float> input;
+        TestHarness::generateTestSignal (input, setup.numChannels, (int) (sampleRate / 4), sampleRate);
+
+        juce::AudioBuffer<float> output (input);
+        TestHarness::render (*processor, output, setup.blockSize);
+
+        expect (TestHarness::isIdentical (input, output), "Dry blend at Volume 2 changed the signal");
+    }
+
+    void checkDryLatency()
+    {
+        // Linear-phase 2x oversampling: an impulse through the dry path has
+        // to come out exactly as late as the processor says it will
+        TestHarness::Setup setup;
+        setup.parameters = "blend:0,volume:2,quality:1,filter:1,ir:0";
+
+        auto processor = TestHarness::createProcessor (setup);
+        expect (processor != nullptr);
+
+        if (processor == nullptr)
+            return;
+
+        const auto latency = processor->getLatencySamples();
+        expectGreaterThan (latency, 0);
+
+        const int impulsePosition = 1000;
+        juce::AudioBuffer<float> buffer (setup.numChannels, 4096);
+        buffer.clear();
+
+        for (int channel = 0; channel < setup.numChannels; ++channel)
+            buffer.setSample (channel, impulsePosition, 1.0f);
+
+        TestHarness::render (*processor, buffer, setup.blockSize);
+
+        for (int channel = 0; channel < setup.numChannels; ++channel)
+        {
+            const auto* samples = buffer.getReadPointer (channel);
+            const auto peak = (int) (std::max_element (samples, samples + buffer.getNumSamples(),
+                                                       [] (float a, float b) { return std::abs (a) < std::abs (b); })
+                                     - samples);
+
+            expectEquals (peak, impulsePosition + latency, "The dry path isn't delayed by the reported latency");
+            expectGreaterThan (std::abs (samples[peak]), 0.5f);
+        }
+    }
+
+    void checkSteppedAutomation (bool offline)
+    {
+        // Fully dry, the output is exactly input * Volume / 2, so every sample
+        // shows which step of the lane it was rendered with. Steps fall mid
+        // block, on a block boundary and one sample past one.
+        TestHarness::Setup setup;
+        setup.offline = offline;
+        setup.parameters = "blend:0,volume:2,ir:0";
+
+        auto processor = TestHarness::createProcessor (setup);
+        expect (processor != nullptr);
+
+        if (processor == nullptr)
+            return;
+
+        struct Step { int position; float volume; };
+        const Step lane[] = { { 1000, 1.0f }, { 1536, 0.5f }, { 2049, 1.5f }, { 5000, 2.0f }, { 7777, 0.25f } };
+
+        for (auto& step : lane)
+            expect (processor->scheduleParameterChange (volumeParameter, step.volume, step.position));
+
+        juce::AudioBuffer<float> input;
+        TestHarness::generateTestSignal (input, setup.numChannels, (int) (sampleRate / 4), sampleRate);
+
+        juce::AudioBuffer<float> output (input);
+        TestHarness::render (*processor, output, setup.blockSize);
+
+        auto volume = 2.0f;
+        int nextStep = 0, firstWrong = -1;
+
+        for (int i = 0; i < input.getNumSamples() && firstWrong < 0; ++i)
+        {
+            if (nextStep < juce::numElementsInArray (lane) && i == lane[nextStep].position)
+                volume = lane[nextStep++].volume;
+
+            for (int channel = 0; channel < input.getNumChannels(); ++channel)
+                if (output.getSample (channel, i) != input.getSample (channel, i) * (volume / 2.0f))
+                    firstWrong = i;
+        }
+
+        expectEquals (firstWrong, -1, "The lane wasn't followed from this sample on");
+    }
+
+    template <typename SampleType>
+    void checkParallelRender()
+    {
+        // Every stage that keeps state across samples, and events mid-block
+        TestHarness::Setup setup;
+        setup.numChannels = 8;
+        setup.blockSize = 1024;
+        setup.offline = true;
+        setup.useDouble = std::is_same<SampleType, double>::value;
+        setup.parameters = "drive:0.7,range:60,blend:0.8,quality:2,filter:1,bands:2,dynamics:0.5,"
+                           "lowcut:90,bass:3,cabinet:8000,ir:0";
+
+        juce::AudioBuffer<SampleType> input;
+        TestHarness::generateTestSignal (input, setup.numChannels, (int) sampleRate, sampleRate);
+
+        juce::AudioBuffer<SampleType> outputs[2];
+        const int threads[] = { 1, 4 };
+
+        for (int i = 0; i < 2; ++i)
+        {
+            setup.maxOfflineThreads = threads[i];
+
+            auto processor = TestHarness::createProcessor (setup);
+            expect (processor != nullptr);
+
+            if (processor == nullptr)
+                return;
+
+            expectEquals (processor->getNumOfflineThreads(), threads[i]);
+
+            processor->scheduleParameterChange (driveParameter, 0.2f, 3000);
+            processor->scheduleParameterChange (blendParameter, 0.5f, 3001);
+            processor->scheduleParameterChange (driveParameter, 0.9f, 20000);
+
+            outputs[i] = input;
+            TestHarness::render (*processor, outputs[i], setup.blockSize);
+        }
+
+        expect (TestHarness::isFinite (outputs[0]));
+        expect (TestHarness::isIdentical (outputs[0], outputs[1]), "Parallel render differs from the serial one");
+    }
+
+    void checkSilence()
+    {
+        // Signal, then silence well past the oversampling filters' tail
+        TestHarness::Setup setup;
+        setup.blockSize = 256;
+        setup.parameters = "quality:2,ir:0";
+
+        auto processor = TestHarness::createProcessor (setup);
+        expect (processor != nullptr);
+
+        if (processor == nullptr)
+            return;
+
+        juce::AudioBuffer<float> buffer;
+        TestHarness::generateTestSignal (buffer, setup.numChannels, (int) (sampleRate / 2), sampleRate);
+
+        const auto signalLength = (int) (sampleRate / 10);
+        buffer.clear (signalLength, buffer.getNumSamples() - signalLength);
+
+        TestHarness::render (*processor, buffer, setup.blockSize);
+
+        expectGreaterThan (buffer.getMagnitude (0, signalLength), 0.0f);
+        expectGreaterThan ((int) processor->getNumSkippedBlocks(), 0, "Silent blocks were processed");
+        expectEquals (buffer.getMagnitude (buffer.getNumSamples() - setup.blockSize, setup.blockSize), 0.0f);
+    }
+
+    void checkProgramSwitch()
+    {
+        // From the default program to "Edge of Breakup", which moves Drive,
+        // Range, Blend and Volume and leaves the oversampling off. Against a
+        // render that stays on the default, the switched one has to part
+        // from it over the smoothing time, not within a few samples.
+        TestHarness::Setup setup;
+        const int program = 1;
+
+        auto steady = TestHarness::createProcessor (setup);
+        auto switched = TestHarness::createProcessor (setup);
+        expect (steady != nullptr && switched != nullptr);
+
+        if (steady == nullptr || switched == nullptr)
+            return;
+
+        expectEquals (switched->getProgramName (program), juce::String ("Edge of Breakup"));
+
+        juce::AudioBuffer<float> input;
+        TestHarness::generateTestSignal (input, setup.numChannels, (int) (sampleRate / 2), sampleRate);
+
+        juce::AudioBuffer<float> expected (input), output (input);
+        TestHarness::render (*steady, expected, setup.blockSize);
+
+        const auto switchPosition = 8 * setup.blockSize;
+        const auto numSamples = output.getNumSamples();
+        juce::AudioBuffer<float> before (output.getArrayOfWritePointers(), setup.numChannels, 0, switchPosition);
+        juce::AudioBuffer<float> after (output.getArrayOfWritePointers(), setup.numChannels, switchPosition, numSamples - switchPosition);
+
+        TestHarness::render (*switched, before, setup.blockSize);
+        switched->setCurrentProgram (program);
+        TestHarness::render (*switched, after, setup.blockSize);
+
+        auto maxDifference = [&] (int start, int length)
+        {
+            float difference = 0;
+
+            for (int channel = 0; channel < setup.numChannels; ++channel)
+                for (int i = start; i < start + length; ++i)
+                    difference = juce::jmax (difference, std::abs (output.getSample (channel, i) - expected.getSample (channel, i)));
+
+            return difference;
+        };
+
+        // Well past the 20 ms smoothers, the two renders are far apart
+        const auto settledPosition = switchPosition + (int) (sampleRate / 10);
+        const auto settled = maxDifference (settledPosition, numSamples - settledPosition);
+        const auto jump = maxDifference (switchPosition, 8);
+
+        expectEquals (maxDifference (0, switchPosition), 0.0f, "The renders differ before the switch");
+        expectGreaterThan (settled, 0.1f);
+        expectLessThan (jump, settled * 0.05f, "The program switch stepped");
+    }
+};
+
+static DspTests dspTests;
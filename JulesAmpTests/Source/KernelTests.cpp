@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    KernelTests.cpp
+    Created: 17 Oct 2026
+
+    Checks every atan kernel the CPU can run, the reference one included,
+    directly against std::atan over the whole drive * range domain. The
+    bound is Waveshaper::maxAtanError.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class KernelTests  : public juce::UnitTest
+{
+public:
+    KernelTests()  : juce::UnitTest ("Waveshaper kernels", "JulesAmp DSP") {}
+
+    void runTest() override
+    {
+        checkImplementations<float> ("float");
+        checkImplementations<double> ("double");
+    }
+
+private:
+    /** Drive * range reaches 1500. */
+    static constexpr double maxInput = 1500.0;
+
+    /** Dense around zero where the curve bends, then log-spaced out to
+        +-maxInput, plus the fold at 1 and an odd count so the kernels finish
+        on a partial vector.
+    */
+    template <typename SampleType>
+    static juce::Array<SampleType> getInputs()
+    {
+        juce::Array<SampleType> inputs;
+
+        for (int i = -20000; i <= 20000; ++i)
+            inputs.add ((SampleType) (i * 1.0e-4));
+
+        for (double x = 2.0; x < maxInput; x *= 1.001)
+        {
+            inputs.add ((SampleType) x);
+            inputs.add ((SampleType) -x);
+        }
+
+        for (auto x : { maxInput, -maxInput, 1.0, -1.0 })
+        {
+            inputs.add ((SampleType) x);
+            inputs.add (std::nextafter ((SampleType) x, (SampleType) 0));
+        }
+
+        if (inputs.size() % 2 == 0)
+            inputs.add ((SampleType) 3);
+
+        return inputs;
+    }
+
+    template <typename SampleType>
+    void checkImplementations (const juce::String& precision)
+    {
+        using Shaper = Waveshaper<SampleType>;
+        using Implementation = typename Shaper::Implementation;
+
+        for (auto implementation : { Implementation::reference, Implementation::scalar, Implementation::sse2,
+                                     Implementation::avx2, Implementation::neon })
+        {
+            const auto name = Shaper::getImplementationName (implementation) + ", " + precision;
+
+            if (! Shaper::isSupported (implementation))
+            {
+                logMessage (name + ": not available on this CPU or build, skipped");
+                continue;
+            }
+
+            beginTest ("Atan error against std::atan, " + name);
+
+            Shaper shaper;
+            shaper.setImplementation (implementation);
+            expect (shaper.getImplementation() == implementation);
+
+            const auto inputs = getInputs<SampleType>();
+            const auto numSamples = inputs.size();
+
+            // Blend 1 at Volume 2 leaves atan (x) * 2 / pi, nothing else
+            juce::HeapBlock<SampleType> output ((size_t) numSamples), gain ((size_t) numSamples),
+                                        blend ((size_t) numSamples), volume ((size_t) numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                gain[i] = 1;
+                blend[i] = 1;
+                volume[i] = 2;
+            }
+
+            for (auto ramped : { false, true })
+            {
+                std::copy (inputs.begin(), inputs.end(), output.get());
+                SampleType* channels[] = { output.get() };
+
+                if (ramped)
+                    shaper.processRamped (channels, 1, numSamples, gain, blend, volume);
+                else
+                    shaper.process (channels, 1, numSamples, (SampleType) 1, (SampleType) 1, (SampleType) 2);
+
+                double maxError = 0, worstInput = 0;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto x = (double) inputs.getUnchecked (i);
+                    const auto error = std::abs ((double) output[i] * juce::MathConstants<double>::halfPi - std::atan (x));
+
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        worstInput = x;
+                    }
+                }
+
+                expectLessOrEqual (maxError, Shaper::maxAtanError,
+                                   name + (ramped ? " ramped" : "") + ": " + juce::String (maxError, 10)
+                                     + " rad at x = " + juce::String (worstInput));
+
+                logMessage (name + (ramped ? " ramped" : "") + ": max error " + juce::String (maxError, 10) + " rad");
+            }
+        }
+    }
+};
+
+static KernelTests kernelTests;
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026
+
+    Headless regression and performance tests for JulesAmpAudioProcessor.
+    Runs every juce::UnitTest registered in this target and exits non-zero
+    when any of them failed, so a CI step can gate on it.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+namespace
+{
+    const char* usage =
+        "Usage: JulesAmpTests [options]\n"
+        "\n"
+        "  --category=<name>       run one category: \"JulesAmp DSP\", \"JulesAmp State\",\n"
+        "                          \"JulesAmp Layout\" or \"JulesAmp Performance\"\n"
+        "  --skip-benchmarks       everything but the performance tests\n"
+        "  --baselines=<file>      ns/sample baselines (default Baselines.json in the working directory)\n"
+        "  --tolerance=<percent>   slowdown over a baseline that fails a benchmark (default 10)\n"
+        "  --record-baselines      write this machine's numbers to the baselines file instead of checking\n"
+        "  --require-baselines     fail when the baselines are missing or were recorded on another CPU\n"
+        "                          or build, rather than just reporting the numbers\n"
+        "  --seconds=<s>           audio rendered per timed run (default 0.5)\n";
+
+    const char* performanceCategory = "JulesAmp Performance";
+}
+
+namespace TestHarness
+{
+    Options& getOptions()
+    {
+        static Options options;
+        return options;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << usage;
+        return 0;
+    }
+
+    auto& options = TestHarness::getOptions();
+    options.recordBaselines = args.containsOption ("--record-baselines");
+    options.requireBaselines = args.containsOption ("--require-baselines");
+    options.baselines = args.containsOption ("--baselines") ? args.getFileForOption ("--baselines")
+                                                            : juce::File::getCurrentWorkingDirectory().getChildFile ("Baselines.json");
+
+    if (args.containsOption ("--tolerance"))
+        options.tolerancePercent = juce::jmax (0.0, args.getValueForOption ("--tolerance").getDoubleValue());
+
+    if (args.containsOption ("--seconds"))
+        options.benchmarkSeconds = juce::jmax (0.01, args.getValueForOption ("--seconds").getDoubleValue());
+
+    juce::Array<juce::UnitTest*> tests;
+
+    for (auto* test : juce::UnitTest::getAllTests())
+    {
+        if (args.containsOption ("--category") && test->getCategory() != args.getValueForOption ("--category"))
+            continue;
+
+        if (args.containsOption ("--skip-benchmarks") && test->getCategory() == performanceCategory)
+            continue;
+
+        // Recording baselines shouldn't wait on the rest
+        if (options.recordBaselines && test->getCategory() != performanceCategory)
+            continue;
+
+        tests.add (test);
+    }
+
+    if (tests.isEmpty())
+    {
+        std::cerr << "No tests to run" << std::endl;
+        return 1;
+    }
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+    runner.runTests (tests);
+
+    int numPasses = 0, numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+    {
+        numPasses += runner.getResult (i)->passes;
+        numFailures += runner.getResult (i)->failures;
+    }
+
+    std::cout << std::endl << numPasses << " passed, " << numFailures << " failed" << std::endl;
+    return numFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,369 @@
+/*
+  ==============================================================================
+
+    PerformanceTests.cpp
+    Created: 17 Oct 2026
+
+    Microbenchmarks of the hot paths through processBlock, in ns per channel
+    sample, checked against the baselines recorded for this machine. A
+    benchmark fails when it's slower than its baseline by more than the
+    tolerance (--tolerance, 10% by default); --record-baselines writes the
+    current numbers instead. The shaper table is also timed against the
+    scalar atan kernel, the path it stands in for, at every block size from
+    16 to 4096, and has to beat it at each. Every curve's kernel has to stay
+    within Waveshaper::maxCostAgainstAtan of atan's on the same instruction
+    set; those two checks compare numbers from the same run, so they need
+    no baselines.
+
+    Baselines only mean something for the CPU and build they were recorded
+    with. Without baselines for this CPU and build the checks are skipped,
+    with a log line saying so, and the numbers are just reported; a machine
+    that runs the tests for CI passes --require-baselines to fail instead.
+    Once matching baselines exist, a benchmark missing from them fails.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class PerformanceTests  : public juce::UnitTest
+{
+public:
+    PerformanceTests()  : juce::UnitTest ("Hot path ns/sample", "JulesAmp Performance") {}
+
+    void runTest() override
+    {
+        auto& options = TestHarness::getOptions();
+        auto baselines = juce::JSON::parse (options.baselines);
+
+        beginTest ("Baselines for this CPU and build");
+        const auto checking = ! options.recordBaselines && hasComparableBaselines (baselines);
+
+        juce::DynamicObject::Ptr recorded (new juce::DynamicObject());
+
+        for (auto& benchmark : benchmarks)
+        {
+            beginTest (benchmark.name);
+            check (benchmark.name, measure (benchmark, blockSize), baselines, checking, *recorded);
+        }
+
+        for (auto size : sweepBlockSizes)
+        {
+            beginTest ("Table against scalar atan, block " + juce::String (size));
+            checkTableSpeedup<float> (size);
+            checkTableSpeedup<double> (size);
+        }
+
+        beginTest ("Curve cost against atan, float");
+        checkCurveCosts<float>();
+
+        beginTest ("Curve cost against atan, double");
+        checkCurveCosts<double>();
+
+        if (options.recordBaselines)
+        {
+            juce::DynamicObject::Ptr root (new juce::DynamicObject());
+            root->setProperty ("cpu", getCpuName());
+            root->setProperty ("build", getBuildName());
+            root->setProperty ("benchmarks", juce::var (recorded.get()));
+
+            expect (options.baselines.replaceWithText (juce::JSON::toString (juce::var (root.get()))),
+                    "Can't write " + options.baselines.getFullPathName());
+            logMessage ("Baselines written to " + options.baselines.getFullPathName());
+        }
+    }
+
+private:
+    struct Benchmark
+    {
+        const char* name;
+        const char* parameters;     // on top of a driven, partly dry setting
+        int numChannels;
+        bool useDouble;
+        bool silent;
+    };
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int numRuns = 5;
+
+    // The high resolution table and the scalar atan kernel, timed at each of these block sizes
+    static constexpr int sweepBlockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    static constexpr double sweepGain = 32.0;
+
+    // One per path processBlock can take. Names are the baseline keys, so
+    // renaming one drops its baseline.
+    static constexpr Benchmark benchmarks[] =
+    {
+        { "atan",                   "",                                             2,  false, false },
+        { "atan double",            "",                                             2,  true,  false },
+        { "tanh",                   "curve:1",                                      2,  false, false },
+        { "hard clip",              "curve:2",                                      2,  false, false },
+        { "diode",                  "curve:3",                                      2,  false, false },
+        { "foldback",               "curve:4",                                      2,  false, false },
+        { "cubic",                  "curve:5",                                      2,  false, false },
+        { "oversampling 2x IIR",    "quality:1",                                    2,  false, false },
+        { "oversampling 8x FIR",    "quality:3,filter:1",                           2,  false, false },
+        { "multiband 4 bands",      "bands:3",                                      2,  false, false },
+        { "voicing",                "lowcut:80,emphasis:6,bass:3,mid:-2,treble:4,cabinet:6000", 2, false, false },
+        { "dynamics",               "dynamics:0.6,attack:2,release:80",             2,  false, false },
+        { "12 channels",            "",                                             12, false, false },
+        { "silence",                "quality:1",                                    2,  false, true  },
+    };
+
+    static juce::String getCpuName()
+    {
+        return juce::SystemStats::getCpuModel().trim() + ", " + juce::String (juce::SystemStats::getNumCpus()) + " cores";
+    }
+
+    static juce::String getBuildName()
+    {
+       #if JUCE_DEBUG
+        return "Debug";
+       #else
+        return "Release";
+       #endif
+    }
+
+    /** True when the baselines file was recorded on this CPU and build.
+        Otherwise logs that the checks are skipped, or fails the test with
+        --require-baselines.
+    */
+    bool hasComparableBaselines (const juce::var& baselines)
+    {
+        const auto& options = TestHarness::getOptions();
+        juce::String problem;
+
+        if (! options.baselines.existsAsFile())
+            problem = "No baselines at " + options.baselines.getFullPathName();
+        else if (! baselines["benchmarks"].isObject())
+            problem = options.baselines.getFullPathName() + " holds no baselines";
+        else if (baselines["cpu"].toString() != getCpuName() || baselines["build"].toString() != getBuildName())
+            problem = "Baselines were recorded on " + baselines["cpu"].toString() + " (" + baselines["build"].toString()
+                    + "), not this " + getCpuName() + " (" + getBuildName() + ")";
+
+        if (problem.isEmpty())
+            return true;
+
+        if (options.requireBaselines)
+            expect (false, problem + ". Run with --record-baselines on this machine");
+        else
+            logMessage ("SKIPPED baseline checks: " + problem + ". Reporting the numbers only.");
+
+        return false;
+    }
+
+    /** Logs a result next to its baseline, fails it if it regressed, and
+        keeps it for --record-baselines.
+    */
+    void check (const juce::String& name, double nsPerSample, const juce::var& baselines,
+                bool checking, juce::DynamicObject& recorded)
+    {
+        const auto& options = TestHarness::getOptions();
+        const auto baseline = (double) baselines["benchmarks"][juce::Identifier (name)];
+        recorded.setProperty (name, std::round (nsPerSample * 1000.0) / 1000.0);
+
+        auto message = name + ": " + juce::String (nsPerSample, 3) + " ns/sample";
+
+        if (baseline <= 0)
+        {
+            logMessage (message);
+
+            if (checking)
+                expect (false, "No baseline for " + name + ", record the baselines again with --record-baselines");
+
+            return;
+        }
+
+        const auto change = 100.0 * (nsPerSample / baseline - 1.0);
+        message << ", baseline " << juce::String (baseline, 3) << " (" << (change >= 0 ? "+" : "")
+                << juce::String (change, 1) << "%)";
+        logMessage (message);
+
+        if (checking)
+            expectLessOrEqual (nsPerSample, baseline * (1.0 + options.tolerancePercent / 100.0),
+                               name + " regressed by " + juce::String (change, 1) + "%");
+    }
+
+    /** Real-time processing at a host block size, best of several runs. */
+    double measure (const Benchmark& benchmark, int hostBlockSize)
+    {
+        TestHarness::Setup setup;
+        setup.numChannels = benchmark.numChannels;
+        setup.blockSize = hostBlockSize;
+        setup.useDouble = benchmark.useDouble;
+        setup.parameters = juce::String ("drive:0.8,range:40,blend:0.9,volume:1.2,ir:0,") + benchmark.parameters;
+
+        auto processor = TestHarness::createProcessor (setup);
+        expect (processor != nullptr, juce::String ("Can't set up ") + benchmark.name);
+
+        if (processor == nullptr)
+            return 0;
+
+        return benchmark.useDouble ? timeRenders<double> (*processor, benchmark, hostBlockSize)
+                                   : timeRenders<float> (*processor, benchmark, hostBlockSize);
+    }
+
+    /** Times the table and the scalar kernel it replaces on the same block,
+        with the fastest kernel this CPU has alongside for reference, and
+        fails if the table isn't the quicker of the two scalar paths.
+    */
+    template <typename SampleType>
+    void checkTableSpeedup (int size)
+    {
+        const auto precision = std::is_same<SampleType, double>::value ? "double" : "float";
+        const auto numSamples = (int) (sampleRate * TestHarness::getOptions().benchmarkSeconds);
+
+        juce::AudioBuffer<SampleType> source, buffer;
+        TestHarness::generateTestSignal (source, 1, numSamples, sampleRate);
+
+        ShaperTable::Table table;
+        ShaperTable::build (table, { ShaperTable::high, Waveshaper<SampleType>::atanCurve });
+
+        Waveshaper<SampleType> scalar, best;
+        scalar.setImplementation (Waveshaper<SampleType>::Implementation::scalar);
+
+        const auto gain = (SampleType) sweepGain, blend = (SampleType) 0.9, volume = (SampleType) 1.2;
+
+        const auto tableNs = timeBlocks (source, buffer, size, [&] (SampleType* data, int n)
+        {
+            ShaperTable::process (table, data, n, gain, blend, volume);
+        });
+
+        const auto scalarNs = timeBlocks (source, buffer, size, [&] (SampleType* data, int n)
+        {
+            scalar.process (&data, 1, n, gain, blend, volume);
+        });
+
+        const auto bestNs = timeBlocks (source, buffer, size, [&] (SampleType* data, int n)
+        {
+            best.process (&data, 1, n, gain, blend, volume);
+        });
+
+        logMessage (juce::String (precision) + ", block " + juce::String (size) + ": table "
+                      + juce::String (tableNs, 3) + ", scalar " + juce::String (scalarNs, 3) + " ns/sample ("
+                      + juce::String (scalarNs / tableNs, 2) + "x), "
+                      + Waveshaper<SampleType>::getImplementationName (best.getImplementation())
+                      + " " + juce::String (bestNs, 3));
+
+        expectLessThan (tableNs, scalarNs, juce::String ("Table slower than scalar atan, ") + precision
+                                             + ", block " + juce::String (size));
+    }
+
+    /** Times every curve's kernel on each implementation this CPU runs, bar
+        the reference one, and fails any costing more than the bound times atan.
+    */
+    template <typename SampleType>
+    void checkCurveCosts()
+    {
+        using Shaper = Waveshaper<SampleType>;
+        using Implementation = typename Shaper::Implementation;
+
+        const char* curveNames[] = { "atan", "tanh", "hard clip", "diode", "foldback", "cubic" };
+        static_assert (juce::numElementsInArray (curveNames) == Shaper::numCurves, "Name every curve");
+
+        const auto precision = std::is_same<SampleType, double>::value ? "double" : "float";
+        const auto numSamples = (int) (sampleRate * TestHarness::getOptions().benchmarkSeconds);
+
+        juce::AudioBuffer<SampleType> source, buffer;
+        TestHarness::generateTestSignal (source, 1, numSamples, sampleRate);
+
+        const auto gain = (SampleType) sweepGain, blend = (SampleType) 0.9, volume = (SampleType) 1.2;
+
+        for (auto implementation : { Implementation::scalar, Implementation::sse2, Implementation::avx2, Implementation::neon })
+        {
+            if (! Shaper::isSupported (implementation))
+                continue;
+
+            Shaper shaper;
+            shaper.setImplementation (implementation);
+            double nsPerSample[Shaper::numCurves] = {};
+
+            for (int curve = 0; curve < Shaper::numCurves; ++curve)
+            {
+                shaper.setCurve (curve, 0);
+
+                nsPerSample[curve] = timeBlocks (source, buffer, blockSize, [&] (SampleType* data, int n)
+                {
+                    shaper.process (&data, 1, n, gain, blend, volume);
+                });
+            }
+
+            for (int curve = 0; curve < Shaper::numCurves; ++curve)
+            {
+                const auto name = juce::String (curveNames[curve]) + ", " + Shaper::getImplementationName (implementation)
+                                    + ", " + precision;
+                const auto ratio = nsPerSample[curve] / nsPerSample[Shaper::atanCurve];
+
+                logMessage (name + ": " + juce::String (nsPerSample[curve], 3) + " ns/sample, "
+                              + juce::String (ratio, 2) + "x atan");
+                expectLessOrEqual (ratio, Shaper::maxCostAgainstAtan, name + " costs too much against atan");
+            }
+        }
+    }
+
+    /** Best of several runs of shape over source, size samples at a time. */
+    template <typename SampleType, typename Shape>
+    static double timeBlocks (const juce::AudioBuffer<SampleType>& source, juce::AudioBuffer<SampleType>& buffer,
+                              int size, Shape&& shape)
+    {
+        const auto numSamples = source.getNumSamples();
+        double best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run <= numRuns; ++run)
+        {
+            buffer.makeCopyOf (source, true);
+            auto* data = buffer.getWritePointer (0);
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            for (int start = 0; start < numSamples; start += size)
+                shape (data + start, juce::jmin (size, numSamples - start));
+
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+            // The first run only warms up
+            if (run > 0)
+                best = juce::jmin (best, elapsed);
+        }
+
+        return best * 1.0e9 / numSamples;
+    }
+
+    template <typename SampleType>
+    double timeRenders (JulesAmpAudioProcessor& processor, const Benchmark& benchmark, int hostBlockSize)
+    {
+        const auto numSamples = (int) (sampleRate * TestHarness::getOptions().benchmarkSeconds);
+
+        juce::AudioBuffer<SampleType> source, buffer;
+        TestHarness::generateTestSignal (source, benchmark.numChannels, numSamples, sampleRate);
+
+        if (benchmark.silent)
+            source.clear();
+
+        // Warm up, and give the background shaper table build time to land
+        buffer.makeCopyOf (source);
+        TestHarness::render (processor, buffer, hostBlockSize);
+        juce::Thread::sleep (200);
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            buffer.makeCopyOf (source, true);
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            TestHarness::render (processor, buffer, hostBlockSize);
+            const auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+            best = juce::jmin (best, elapsed);
+        }
+
+        return best * 1.0e9 / ((double) numSamples * benchmark.numChannels);
+    }
+};
+
+constexpr PerformanceTests::Benchmark PerformanceTests::benchmarks[];
+constexpr int PerformanceTests::sweepBlockSizes[];
+
+static PerformanceTests performanceTests;
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    StateTests.cpp
+    Created: 17 Oct 2026
+
+    Save/restore round trips through getStateInformation and
+    setStateInformation, for the current binary format, the ValueTree blobs
+    older versions saved, and blobs written by older and newer versions of
+    the format.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class StateTests  : public juce::UnitTest
+{
+public:
+    StateTests()  : juce::UnitTest ("State save and restore", "JulesAmp State") {}
+
+    void runTest() override
+    {
+        beginTest ("Every parameter survives a round trip");
+        {
+            JulesAmpAudioProcessor source, restored;
+            setNonDefaultValues (source);
+
+            juce::MemoryBlock blob;
+            source.getStateInformation (blob);
+            restored.setStateInformation (blob.getData(), (int) blob.getSize());
+
+            expectSameValues (restored, source);
+        }
+
+        beginTest ("The program survives a round trip");
+        {
+            JulesAmpAudioProcessor source, restored;
+            const auto program = source.getNumPrograms() - 1;
+            source.setCurrentProgram (program);
+
+            juce::MemoryBlock blob;
+            source.getStateInformation (blob);
+            restored.setStateInformation (blob.getData(), (int) blob.getSize());
+
+            expectEquals (restored.getCurrentProgram(), program);
+            expectSameValues (restored, source);
+        }
+
+        beginTest ("Legacy ValueTree blobs restore");
+        {
+            JulesAmpAudioProcessor source, restored;
+            setNonDefaultValues (source);
+
+            juce::MemoryBlock blob;
+            juce::MemoryOutputStream stream (blob, false);
+            source.getState().copyState().writeToStream (stream);
+            stream.flush();
+
+            restored.setStateInformation (blob.getData(), (int) blob.getSize());
+            expectSameValues (restored, source, false);
+        }
+
+        beginTest ("Older blobs leave newer parameters at their defaults");
+        {
+            // Version 1 with the first seven parameters, before the multiband ones existed
+            JulesAmpAudioProcessor source, restored;
+            setNonDefaultValues (source);
+            setNonDefaultValues (restored);
+
+            const int numValues = 7;
+            juce::MemoryBlock blob;
+            writeBlob (source, blob, 1, numValues);
+            restored.setStateInformation (blob.getData(), (int) blob.getSize());
+
+            for (int i = 0; i < StateFormat::numParameters; ++i)
+            {
+                auto* param = restored.getState().getParameter (StateFormat::parameterIDs[i]);
+
+                if (i < numValues)
+                    expectSameValue (restored, source, i, false);
+                else
+                    expectWithinAbsoluteError (param->convertFrom0to1 (param->getValue()),
+                                               param->convertFrom0to1 (param->getDefaultValue()),
+                                               getTolerance (*param),
+                                               juce::String (StateFormat::parameterIDs[i]) + " isn't back at its default");
+            }
+        }
+
+        beginTest ("Newer blobs with unknown parameters restore the known ones");
+        {
+            JulesAmpAudioProcessor source, restored;
+            setNonDefaultValues (source);
+
+            juce::MemoryBlock blob;
+            writeBlob (source, blob, StateFormat::currentVersion + 1, StateFormat::numParameters + 3);
+            restored.setStateInformation (blob.getData(), (int) blob.getSize());
+
+            expectSameValues (restored, source);
+        }
+
+        beginTest ("Damaged blobs are ignored");
+        {
+            JulesAmpAudioProcessor source, restored;
+            setNonDefaultValues (source);
+            setNonDefaultValues (restored);
+
+            juce::MemoryBlock blob;
+            source.getStateInformation (blob);
+
+            juce::MemoryBlock garbage (256);
+            juce::Random random (1234);
+
+            for (size_t i = 0; i < garbage.getSize(); ++i)
+                garbage[i] = (char) random.nextInt (256);
+
+            restored.setStateInformation (nullptr, 0);
+            restored.setStateInformation (blob.getData(), 10);
+            restored.setStateInformation (blob.getData(), (int) blob.getSize() / 2);
+            restored.setStateInformation (garbage.getData(), (int) garbage.getSize());
+
+            expectSameValues (restored, source);
+        }
+    }
+
+private:
+    /** Moves every saved parameter well away from its default. Choices and
+        switches land on a different option.
+    */
+    void setNonDefaultValues (JulesAmpAudioProcessor& processor)
+    {
+        for (int i = 0; i < StateFormat::numParameters; ++i)
+        {
+            auto* param = processor.getState().getParameter (StateFormat::parameterIDs[i]);
+            param->setValueNotifyingHost (param->getDefaultValue() >= 0.5f ? 0.1f + 0.002f * (float) i
+                                                                           : 0.9f - 0.002f * (float) i);
+
+            // A round trip that loses this one would otherwise go unnoticed
+            expect (std::abs (param->getValue() - param->getDefaultValue()) > 0.05f,
+                    juce::String (StateFormat::parameterIDs[i]) + " is still at its default");
+        }
+    }
+
+    /** A blob in the binary format as another version of it would write it:
+        normalised values from version 3, parameter units before that. Values
+        past numParameters are made up, and the IR path is empty.
+    */
+    static void writeBlob (JulesAmpAudioProcessor& source, juce::MemoryBlock& dest, int version, int numValues)
+    {
+        juce::MemoryOutputStream out (dest, false);
+        out.writeInt ((int) StateFormat::magic);
+        out.writeShort ((short) version);
+        out.writeShort ((short) numValues);
+        out.writeInt (source.getCurrentProgram());
+
+        for (int i = 0; i < numValues; ++i)
+        {
+            auto* param = i < StateFormat::numParameters ? source.getState().getParameter (StateFormat::parameterIDs[i])
+                                                         : nullptr;
+            if (param == nullptr)
+                out.writeFloat (123.0f);
+            else
+                out.writeFloat (version >= 3 ? param->getValue() : param->convertFrom0to1 (param->getValue()));
+        }
+
+        if (version >= 2)
+            out.writeString ({});
+
+        out.flush();
+    }
+
+    /** Legacy blobs store parameter units, so a skewed range can be a rounding
+        step out after converting back; anything bigger is a different value.
+    */
+    static float getTolerance (juce::RangedAudioParameter& param)
+    {
+        return param.getNormalisableRange().getRange().getLength() * 1.0e-6f;
+    }
+
+    /** The current format restores the exact normalised value; blobs in
+        parameter units only get within getTolerance of it.
+    */
+    void expectSameValue (JulesAmpAudioProcessor& actual, JulesAmpAudioProcessor& expected, int index, bool exact = true)
+    {
+        auto* a = actual.getState().getParameter (StateFormat::parameterIDs[index]);
+        auto* e = expected.getState().getParameter (StateFormat::parameterIDs[index]);
+        const auto message = juce::String (StateFormat::parameterIDs[index]) + " wasn't restored";
+
+        if (exact)
+            expectEquals (a->getValue(), e->getValue(), message);
+        else
+            expectWithinAbsoluteError (a->convertFrom0to1 (a->getValue()), e->convertFrom0to1 (e->getValue()),
+                                       getTolerance (*e), message);
+    }
+
+    void expectSameValues (JulesAmpAudioProcessor& actual, JulesAmpAudioProcessor& expected, bool exact = true)
+    {
+        for (int i = 0; i < StateFormat::numParameters; ++i)
+            expectSameValue (actual, expected, i, exact);
+    }
+};
+
+static StateTests stateTests;
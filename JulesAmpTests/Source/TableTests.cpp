@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    TableTests.cpp
+    Created: 17 Oct 2026
+
+    Checks every shaper table resolution and curve against the exact curve,
+    from unity gain up to drive * range = 1500. The bound is
+    ShaperTable::getMaxError.
+
+  ==============================================================================
+*/
+
+#include "TestHarness.h"
+
+class TableTests  : public juce::UnitTest
+{
+public:
+    TableTests()  : juce::UnitTest ("Shaper tables", "JulesAmp DSP") {}
+
+    void runTest() override
+    {
+        for (auto resolution : { (int) ShaperTable::low, (int) ShaperTable::medium, (int) ShaperTable::high })
+        {
+            beginTest ("Table error, " + juce::String (ShaperTable::getNumSegments (resolution)) + " segments per sign");
+            checkResolution<float> (resolution);
+            checkResolution<double> (resolution);
+        }
+    }
+
+private:
+    template <typename SampleType>
+    void checkResolution (int resolution)
+    {
+        const auto precision = std::is_same<SampleType, double>::value ? "double" : "float";
+        const auto bound = ShaperTable::getMaxError (resolution);
+        double worstError = 0;
+
+        // The full input range, and the span right around zero that holds
+        // the whole knee at high gain
+        juce::Array<SampleType> inputs;
+
+        for (int i = -20000; i <= 20000; ++i)
+        {
+            inputs.add ((SampleType) (i * 1.0e-4));
+            inputs.add ((SampleType) (i * 1.0e-7));
+        }
+
+        juce::HeapBlock<SampleType> output ((size_t) inputs.size());
+
+        for (int curve = 0; curve < Waveshaper<SampleType>::numCurves; ++curve)
+        {
+            ShaperTable::Table table;
+            ShaperTable::build (table, { resolution, curve });
+
+            for (auto gain : { 1.0, 3.7, 40.0, 400.0, 1500.0 })
+            {
+                // Blend 1 at Volume 2 leaves the tabulated curve on its own
+                std::copy (inputs.begin(), inputs.end(), output.get());
+                ShaperTable::process (table, output.get(), inputs.size(), (SampleType) gain, (SampleType) 1, (SampleType) 2);
+
+                double maxError = 0, worstInput = 0;
+
+                for (int i = 0; i < inputs.size(); ++i)
+                {
+                    // Against the curve at the argument the kernels see too
+                    const auto u = inputs.getUnchecked (i) * (SampleType) gain;
+                    const auto error = std::abs ((double) output[i] - ShaperTable::evaluate ((double) u, curve));
+
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        worstInput = (double) inputs.getUnchecked (i);
+                    }
+                }
+
+                expectLessOrEqual (maxError, bound,
+                                   "curve " + juce::String (curve) + ", gain " + juce::String (gain) + ", " + precision
+                                     + ": " + juce::String (maxError, 10) + " at x = " + juce::String (worstInput, 8));
+
+                worstError = juce::jmax (worstError, maxError);
+            }
+        }
+
+        logMessage (juce::String (ShaperTable::getNumSegments (resolution)) + " segments per sign, " + precision
+                      + ": max error " + juce::String (worstError, 10) + ", bound " + juce::String (bound, 10));
+    }
+};
+
+static TableTests tableTests;
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    TestHarness.h
+    Created: 17 Oct 2026
+
+    Drives JulesAmpAudioProcessor without a host: sets it up the way a host
+    would (layout, precision, real-time or offline, parameters), then feeds it
+    buffers block by block. Shared by every test in this target.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../JulesAmp/Source/PluginProcessor.h"
+
+namespace TestHarness
+{
+    /** Set from the command line before any test runs. */
+    struct Options
+    {
+        juce::File baselines;               // ns/sample per benchmark, JSON
+        double tolerancePercent = 10.0;     // slowdown over the baseline that fails a benchmark
+        bool recordBaselines = false;
+        bool requireBaselines = false;      // missing or foreign baselines fail instead of skipping the checks
+        double benchmarkSeconds = 0.5;      // of audio per timed run
+    };
+
+    Options& getOptions();
+
+    //==============================================================================
+    /** Everything a host decides before prepareToPlay. */
+    struct Setup
+    {
+        int numChannels = 2;
+        int sidechainChannels = 0;
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        bool offline = false;
+        bool useDouble = false;
+        int maxOfflineThreads = 0;          // 0 leaves the processor's default
+        juce::String parameters;            // "id:value,id:value", in parameter units
+    };
+
+    inline bool setParameter (JulesAmpAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.getState().getParameter (id))
+        {
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+            return true;
+        }
+
+        return false;
+    }
+
+    /** The value the DSP actually sees, after the range snapped it. */
+    inline float getParameter (JulesAmpAudioProcessor& processor, const juce::String& id)
+    {
+        auto* value = processor.getState().getRawParameterValue (id);
+        return value != nullptr ? value->load() : 0.0f;
+    }
+
+    inline bool setParameters (JulesAmpAudioProcessor& processor, const juce::String& pairs)
+    {
+        bool allFound = true;
+
+        for (auto& pair : juce::StringArray::fromTokens (pairs, ",", {}))
+            if (pair.trim().isNotEmpty())
+                allFound = setParameter (processor, pair.upToFirstOccurrenceOf (":", false, false).trim(),
+                                         pair.fromFirstOccurrenceOf (":", false, false).getFloatValue()) && allFound;
+
+        return allFound;
+    }
+
+    /** A processor set up and prepared as described, or nullptr if it turned
+        the layout or a parameter down. Parameters are set before
+        prepareToPlay, so the smoothers start out on them.
+    */
+    inline std::unique_ptr<JulesAmpAudioProcessor> createProcessor (const Setup& setup)
+    {
+        auto processor = std::make_unique<JulesAmpAudioProcessor>();
+
+        processor->setProcessingPrecision (setup.useDouble ? juce::AudioProcessor::doublePrecision
+                                                           : juce::AudioProcessor::singlePrecision);
+        processor->setPlayConfigDetails (setup.numChannels, setup.numChannels, setup.sampleRate, setup.blockSize);
+        processor->setNonRealtime (setup.offline);
+
+        if (setup.maxOfflineThreads > 0)
+            processor->setMaximumOfflineThreads (setup.maxOfflineThreads);
+
+        if (setup.sidechainChannels > 0)
+        {
+            auto layout = processor->getBusesLayout();
+
+            if (layout.inputBuses.size() > 1)
+                layout.inputBuses.getReference (1) = juce::AudioChannelSet::canonicalChannelSet (setup.sidechainChannels);
+
+            processor->setBusesLayout (layout);
+        }
+
+        if (processor->getMainBusNumInputChannels() != setup.numChannels
+         || processor->getChannelCountOfBus (true, 1) != setup.sidechainChannels
+         || ! setParameters (*processor, setup.parameters))
+            return nullptr;
+
+        processor->prepareToPlay (setup.sampleRate, setup.blockSize);
+        return processor;
+    }
+
+    //==============================================================================
+    /** A saw with a slow level swell and a little noise, so the shaper sees
+        both quiet and driven passages. Seeded, so every run gets the same one.
+    */
+    template <typename SampleType>
+    void generateTestSignal (juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples,
+                             double sampleRate, juce::int64 seed = 42)
+    {
+        buffer.setSize (numChannels, numSamples);
+        juce::Random random (seed);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffer.getWritePointer (channel);
+            auto frequency = 110.0 * (1.0 + 0.01 * channel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto t = i / sampleRate;
+                auto saw = 2.0 * (t * frequency - std::floor (t * frequency + 0.5));
+                auto swell = 0.25 + 0.25 * std::sin (juce::MathConstants<double>::twoPi * 0.2 * t);
+                data[i] = (SampleType) (saw * swell + 0.01 * (random.nextDouble() * 2.0 - 1.0));
+            }
+        }
+    }
+
+    /** Processes buffer in place, blockSize samples per callback (the last one
+        may be shorter). key feeds the sidechain bus, when it's enabled;
+        without one the sidechain gets silence.
+    */
+    template <typename SampleType>
+    void render (JulesAmpAudioProcessor& processor, juce::AudioBuffer<SampleType>& buffer, int blockSize,
+                 const juce::AudioBuffer<SampleType>* key = nullptr)
+    {
+        const auto numChannels = buffer.getNumChannels();
+        const auto numSamples = buffer.getNumSamples();
+        const auto sidechainChannels = processor.getChannelCountOfBus (true, 1);
+
+        juce::AudioBuffer<SampleType> keyBlock (juce::jmax (1, sidechainChannels), blockSize);
+        juce::MidiBuffer midi;
+
+        // The sidechain follows the main bus, the way a host lays the buses out in one buffer
+        SampleType* channels[DistortionEngine<float>::maxNumChannels + 2] = {};
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            const auto n = juce::jmin (blockSize, numSamples - start);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                channels[channel] = buffer.getWritePointer (channel, start);
+
+            for (int channel = 0; channel < sidechainChannels; ++channel)
+            {
+                if (key != nullptr && key->getNumChannels() > 0)
+                    keyBlock.copyFrom (channel, 0, *key, channel % key->getNumChannels(), start, n);
+                else
+                    keyBlock.clear (channel, 0, n);
+
+                channels[numChannels + channel] = keyBlock.getWritePointer (channel);
+            }
+
+            juce::AudioBuffer<SampleType> hostBuffer (channels, numChannels + sidechainChannels, n);
+            processor.processBlock (hostBuffer, midi);
+        }
+    }
+
+    //==============================================================================
+    template <typename SampleType>
+    bool isFinite (const juce::AudioBuffer<SampleType>& buffer)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                if (! std::isfinite (buffer.getSample (channel, i)))
+                    return false;
+
+        return true;
+    }
+
+    template <typename SampleType>
+    bool isIdentical (const juce::AudioBuffer<SampleType>& a, const juce::AudioBuffer<SampleType>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            if (std::memcmp (a.getReadPointer (channel), b.getReadPointer (channel),
+                             sizeof (SampleType) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+}